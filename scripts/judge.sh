@@ -1,10 +1,17 @@
 #!/usr/bin/env bash
 set -euo pipefail
 
+VERIFY_IN_PROCESS=0
+if [[ "${1:-}" == "--verify" ]]; then
+    VERIFY_IN_PROCESS=1
+    shift
+fi
+
 if [[ $# -lt 1 ]]; then
-    echo "Usage: $0 <program> [circuit...]" >&2
+    echo "Usage: $0 [--verify] <program> [circuit...]" >&2
     echo "  Example: $0 ./bin/main c17 c432" >&2
     echo "  (omit circuits to run every testcase)" >&2
+    echo "  --verify: let the program hash its answers in memory (<program> <ckt> --verify <sha>)" >&2
     exit 1
 fi
 
@@ -122,21 +129,28 @@ for circuit in "${circuits[@]}"; do
         continue
     fi
 
-    temp_out="$(mktemp)"
     time_log="$(mktemp)"
 
     set +e
-    { "${TIME_CMD[@]}" "${PROGRAM}" "${circuit}" "${temp_out}"; } 2> "${time_log}"
+    if [[ ${VERIFY_IN_PROCESS} -eq 1 ]]; then
+        temp_out=""
+        { "${TIME_CMD[@]}" "${PROGRAM}" "${circuit}" --verify "${ans_sha_path}"; } 2> "${time_log}"
+    else
+        temp_out="$(mktemp)"
+        { "${TIME_CMD[@]}" "${PROGRAM}" "${circuit}" "${temp_out}"; } 2> "${time_log}"
+    fi
     prog_status=$?
     set -e
 
     real_time="$(grep '^real' "${time_log}" | awk '{print $2}' || echo 'N/A')"
     compute_time="$(grep '^compute_time_s' "${time_log}" | awk '{print $2}' | tail -n 1)"
     [[ -z "${compute_time}" ]] && compute_time="N/A"
+    verify_sha="$(grep '^verify_sha' "${time_log}" | awk '{print $2}' | tail -n 1 || true)"
     rm -f "${time_log}"
 
-    if [[ ${prog_status} -ne 0 ]]; then
-        rm -f "${temp_out}"
+    # In --verify mode a mismatch also exits non-zero; it is only a crash without a digest.
+    if [[ ${prog_status} -ne 0 && ( ${VERIFY_IN_PROCESS} -eq 0 || -z "${verify_sha}" ) ]]; then
+        [[ -n "${temp_out}" ]] && rm -f "${temp_out}"
         table_rows+=("${circuit}|FAILED|${real_time}|${compute_time}")
         detail_lines+=("${circuit}: program exited with status ${prog_status}.")
         status=1
@@ -144,7 +158,11 @@ for circuit in "${circuits[@]}"; do
         continue
     fi
 
-    digest="$("${HASH_CMD[@]}" "${temp_out}" | awk '{print $1}')"
+    if [[ ${VERIFY_IN_PROCESS} -eq 1 ]]; then
+        digest="${verify_sha}"
+    else
+        digest="$("${HASH_CMD[@]}" "${temp_out}" | awk '{print $1}')"
+    fi
     expected="$(tr -d '\r\n' < "${ans_sha_path}")"
     if [[ "${digest}" == "${expected}" ]]; then
         table_rows+=("${circuit}|OK|${real_time}|${compute_time}")
@@ -154,7 +172,7 @@ for circuit in "${circuits[@]}"; do
         status=1
     fi
 
-    rm -f "${temp_out}"
+    [[ -n "${temp_out}" ]] && rm -f "${temp_out}"
     render_table
 done
 
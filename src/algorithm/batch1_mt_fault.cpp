@@ -1,5 +1,7 @@
 #include "algorithm/batch1_mt_fault.hpp"
 
+#include <algorithm>
+#include <cstdint>
 #include <limits>
 #include <stdexcept>
 
@@ -11,34 +13,36 @@ namespace algorithm {
 
 namespace {
 
-int evaluateGate(core::GateType type, const std::vector<int>& inputs) {
+template <typename Fetch>
+int evaluateGate(const core::Gate& gate, Fetch fetch) {
+    const auto& inputs = gate.inputs;
     if (inputs.empty()) {
         throw std::runtime_error("Gate missing inputs during DFS simulation");
     }
     auto logical_not = [](int value) { return value ? 0 : 1; };
     auto logical_and = [&]() {
         int result = 1;
-        for (int value : inputs) {
-            result &= value;
+        for (auto net : inputs) {
+            result &= fetch(net);
         }
         return result;
     };
     auto logical_or = [&]() {
         int result = 0;
-        for (int value : inputs) {
-            result |= value;
+        for (auto net : inputs) {
+            result |= fetch(net);
         }
         return result;
     };
     auto logical_xor = [&]() {
         int result = 0;
-        for (int value : inputs) {
-            result ^= value;
+        for (auto net : inputs) {
+            result ^= fetch(net);
         }
         return result;
     };
 
-    switch (type) {
+    switch (gate.type) {
         case core::GateType::And:
             return logical_and();
         case core::GateType::Nand:
@@ -55,86 +59,144 @@ int evaluateGate(core::GateType type, const std::vector<int>& inputs) {
             if (inputs.size() != 1) {
                 throw std::runtime_error("NOT gate expects exactly one input");
             }
-            return logical_not(inputs.front());
+            return logical_not(fetch(inputs.front()));
         case core::GateType::Buf:
             if (inputs.size() != 1) {
                 throw std::runtime_error("BUF gate expects exactly one input");
             }
-            return inputs.front();
+            return fetch(inputs.front());
         case core::GateType::Unknown:
         default:
             throw std::runtime_error("Unknown gate type during DFS simulation");
     }
 }
 
+// Per-thread scratch space, sized once and reused for every fault of every pattern.
+// A net is resolved for the current fault when its stamp equals `epoch`.
+struct DfsWorkspace {
+    struct Frame {
+        core::NetId net;
+        std::size_t next_input;
+    };
+
+    std::vector<int> values;
+    std::vector<uint32_t> stamps;
+    std::vector<Frame> stack;
+    uint32_t epoch{0};
+
+    void init(std::size_t net_count) {
+        values.assign(net_count, 0);
+        stamps.assign(net_count, 0);
+        stack.clear();
+        stack.reserve(net_count + 1);
+        epoch = 0;
+    }
+
+    void nextEpoch() {
+        if (++epoch == 0) {
+            std::fill(stamps.begin(), stamps.end(), 0);
+            epoch = 1;
+        }
+    }
+};
+
+// Pattern-level inputs shared read-only by every thread: `fixed` marks nets whose value
+// comes straight from the pattern (primary inputs and any explicitly assigned net).
+struct PatternInputs {
+    std::vector<int> values;
+    std::vector<uint8_t> fixed;
+};
+
 int dfs(core::NetId target,
         core::NetId fault_wire,
         bool stuck_at_0,
         const core::Circuit& circuit,
         const std::vector<int>& net_to_gate,
-        std::vector<bool>& visited,
-        std::vector<int>& values) {
-    if (target == fault_wire) {
-        visited[target] = true;
-        values[target] = stuck_at_0 ? 0 : 1;
-        return values[target];
-    }
-    if (visited[target]) {
-        return values[target];
+        const PatternInputs& inputs,
+        DfsWorkspace& ws) {
+    auto lookup = [&](core::NetId net, int& value) {
+        if (net == fault_wire) {
+            value = stuck_at_0 ? 0 : 1;
+            return true;
+        }
+        if (ws.stamps[net] == ws.epoch) {
+            value = ws.values[net];
+            return true;
+        }
+        if (inputs.fixed[net]) {
+            value = inputs.values[net];
+            if (value == -1) {
+                throw std::runtime_error("Missing assignment for primary input");
+            }
+            return true;
+        }
+        return false;
+    };
+    auto fetch = [&](core::NetId net) {
+        int value = 0;
+        lookup(net, value);
+        return value;
+    };
+
+    int result = 0;
+    if (lookup(target, result)) {
+        return result;
     }
 
-    const auto net_type = circuit.netType(target);
-    if (net_type == core::NetType::PrimaryInput) {
-        if (values[target] == -1) {
-            throw std::runtime_error("Missing assignment for primary input");
+    const auto& gates = circuit.gates();
+    ws.stack.clear();
+    ws.stack.push_back({target, 0});
+    while (!ws.stack.empty()) {
+        auto& frame = ws.stack.back();
+        const int gate_index = net_to_gate[frame.net];
+        if (gate_index < 0) {
+            throw std::runtime_error("Unable to locate driving gate for net");
         }
-        visited[target] = true;
-        return values[target];
-    }
+        const auto& gate = gates[static_cast<std::size_t>(gate_index)];
 
-    const int gate_index = net_to_gate[target];
-    if (gate_index < 0) {
-        throw std::runtime_error("Unable to locate driving gate for net");
-    }
-    const auto& gate = circuit.gates()[static_cast<std::size_t>(gate_index)];
-    std::vector<int> input_values;
-    input_values.reserve(gate.inputs.size());
-    for (auto input_net : gate.inputs) {
-        input_values.push_back(
-            dfs(input_net, fault_wire, stuck_at_0, circuit, net_to_gate, visited, values));
-    }
+        bool descended = false;
+        while (frame.next_input < gate.inputs.size()) {
+            const core::NetId input = gate.inputs[frame.next_input++];
+            int ignored = 0;
+            if (!lookup(input, ignored)) {
+                ws.stack.push_back({input, 0});
+                descended = true;
+                break;
+            }
+        }
+        if (descended) {
+            continue;
+        }
 
-    const int result = evaluateGate(gate.type, input_values);
-    visited[target] = true;
-    values[target] = result;
-    return result;
+        const core::NetId net = frame.net;
+        ws.values[net] = evaluateGate(gate, fetch);
+        ws.stamps[net] = ws.epoch;
+        ws.stack.pop_back();
+    }
+    return ws.values[target];
 }
 
-std::vector<int> computeReferenceOutputs(const core::Circuit& circuit,
-                                         const std::vector<int>& net_to_gate,
-                                         const io::PatternRow& row) {
+void computeReferenceOutputs(const core::Circuit& circuit,
+                             const std::vector<int>& net_to_gate,
+                             const io::PatternRow& row,
+                             const PatternInputs& inputs,
+                             DfsWorkspace& ws,
+                             std::vector<int>& refs) {
     const auto& outputs = circuit.primaryOutputs();
-    std::vector<int> refs(outputs.size(), 0);
     bool all_provided = (row.provided_outputs.size() == outputs.size());
 
     if (all_provided) {
         for (std::size_t i = 0; i < outputs.size(); ++i) {
             refs[i] = row.provided_outputs.at(outputs[i]);
         }
-        return refs;
+        return;
     }
 
     const core::NetId invalid_net = std::numeric_limits<core::NetId>::max();
-    std::vector<bool> visited(circuit.netCount(), false);
-    std::vector<int> values(circuit.netCount(), -1);
-    for (const auto& entry : row.pattern.assignments) {
-        visited[entry.net] = true;
-        values[entry.net] = entry.value;
-    }
+    ws.nextEpoch();
     for (std::size_t i = 0; i < outputs.size(); ++i) {
-        refs[i] = dfs(outputs[i], invalid_net, false, circuit, net_to_gate, visited, values);
+        refs[i] = dfs(outputs[i], invalid_net, false, circuit, net_to_gate, inputs, ws);
     }
-    return refs;
 }
 
 }  // namespace
@@ -155,52 +217,62 @@ void Batch1MtFaultSimulator::start() {
     if (num_threads_ > 0) {
         omp_set_num_threads(num_threads_);
     }
+    const int thread_count = std::max(1, omp_get_max_threads());
+#else
+    const int thread_count = 1;
 #endif
     const std::size_t net_count = circuit_.netCount();
+    const auto& outputs = circuit_.primaryOutputs();
+
+    std::vector<DfsWorkspace> workspaces(static_cast<std::size_t>(thread_count));
+    for (auto& ws : workspaces) {
+        ws.init(net_count);
+    }
+
+    PatternInputs inputs;
+    inputs.values.assign(net_count, -1);
+    inputs.fixed.assign(net_count, 0);
+    std::vector<int> reference_outputs(outputs.size(), 0);
+    std::vector<FaultEvaluation> evals(net_count);
+
     for (std::size_t pattern_id = 0; pattern_id < rows_.size(); ++pattern_id) {
-        const auto reference_outputs =
-            computeReferenceOutputs(circuit_, net_to_gate_, rows_[pattern_id]);
-        const auto& outputs = circuit_.primaryOutputs();
-        std::vector<FaultEvaluation> evals(net_count);
+        std::fill(inputs.values.begin(), inputs.values.end(), -1);
+        std::fill(inputs.fixed.begin(), inputs.fixed.end(), 0);
+        for (auto pi : circuit_.primaryInputs()) {
+            inputs.fixed[pi] = 1;
+        }
+        for (const auto& entry : rows_[pattern_id].pattern.assignments) {
+            inputs.values[entry.net] = entry.value;
+            inputs.fixed[entry.net] = 1;
+        }
+
+        computeReferenceOutputs(circuit_, net_to_gate_, rows_[pattern_id], inputs,
+                                workspaces.front(), reference_outputs);
 
 #pragma omp parallel for schedule(static)
         for (long long net = 0; net < static_cast<long long>(net_count); ++net) {
-            auto simulateOutputs = [&](bool stuck_at_0) {
-                std::vector<bool> visited(circuit_.netCount(), false);
-                std::vector<int> values(circuit_.netCount(), -1);
-                for (const auto& entry : rows_[pattern_id].pattern.assignments) {
-                    int v = entry.value;
-                    if (entry.net == static_cast<core::NetId>(net)) {
-                        v = stuck_at_0 ? 0 : 1;
-                    }
-                    visited[entry.net] = true;
-                    values[entry.net] = v;
-                }
-                if (static_cast<core::NetId>(net) < circuit_.netCount() &&
-                    values[static_cast<std::size_t>(net)] == -1) {
-                    values[static_cast<std::size_t>(net)] = stuck_at_0 ? 0 : 1;
-                    visited[static_cast<std::size_t>(net)] = true;
-                }
+#ifdef _OPENMP
+            DfsWorkspace& ws = workspaces[static_cast<std::size_t>(omp_get_thread_num())];
+#else
+            DfsWorkspace& ws = workspaces.front();
+#endif
+            const auto fault_wire = static_cast<core::NetId>(net);
 
-                std::vector<int> outs(outputs.size(), 0);
+            // Compare each output as soon as it resolves and stop at the first mismatch.
+            auto outputsEqual = [&](bool stuck_at_0) {
+                ws.nextEpoch();
                 for (std::size_t i = 0; i < outputs.size(); ++i) {
-                    outs[i] = dfs(outputs[i], static_cast<core::NetId>(net), stuck_at_0, circuit_,
-                                  net_to_gate_, visited, values);
+                    const int out = dfs(outputs[i], fault_wire, stuck_at_0, circuit_,
+                                        net_to_gate_, inputs, ws);
+                    if (out != reference_outputs[i]) {
+                        return false;
+                    }
                 }
-                return outs;
+                return true;
             };
 
-            const auto outs0 = simulateOutputs(true);
-            const auto outs1 = simulateOutputs(false);
-
-            bool eq0 = true;
-            bool eq1 = true;
-            for (std::size_t i = 0; i < outputs.size(); ++i) {
-                eq0 &= (outs0[i] == reference_outputs[i]);
-                eq1 &= (outs1[i] == reference_outputs[i]);
-            }
-            evals[static_cast<std::size_t>(net)].stuck0_eq = eq0;
-            evals[static_cast<std::size_t>(net)].stuck1_eq = eq1;
+            evals[static_cast<std::size_t>(net)].stuck0_eq = outputsEqual(true);
+            evals[static_cast<std::size_t>(net)].stuck1_eq = outputsEqual(false);
         }
 
         for (std::size_t net = 0; net < net_count; ++net) {
@@ -9,6 +9,13 @@
 
 namespace algorithm {
 
+namespace {
+
+// Passed as the fault net to simulate the good machine.
+constexpr core::NetId kNoFault = std::numeric_limits<core::NetId>::max();
+
+}  // namespace
+
 Batch64LevelizedMPI::Batch64LevelizedMPI(const core::Circuit& circuit,
                                          const std::vector<io::PatternRow>& rows,
                                          MPI_Comm comm)
@@ -185,14 +192,16 @@ Word Batch64LevelizedMPI::simulateFault(const std::vector<Word>& base_values,
                                         Word mask,
                                         std::vector<Word>& working_values,
                                         std::vector<bool>& ready) const {
-    if (fault_net >= net_count_) {
+    if (fault_net != kNoFault && fault_net >= net_count_) {
         throw std::runtime_error("Fault references unknown net");
     }
 
     working_values = base_values;
     ready = base_ready;
-    working_values[fault_net] = stuck_value & mask;
-    ready[fault_net] = true;
+    if (fault_net != kNoFault) {
+        working_values[fault_net] = stuck_value & mask;
+        ready[fault_net] = true;
+    }
 
     const auto& gates = circuit_.gates();
     for (int level = 1; level <= max_level_; ++level) {
@@ -258,6 +267,8 @@ void Batch64LevelizedMPI::start() {
     const std::size_t outputs_count = primary_outputs_.size();
     std::vector<Word> working_values(net_count_, 0);
     std::vector<bool> ready(net_count_, false);
+    std::vector<Word> good_values(net_count_, 0);
+    std::vector<bool> good_ready(net_count_, false);
 
     for (std::size_t base = 0; base < rows_.size(); base += 64) {
         const std::size_t chunk_size = std::min<std::size_t>(64, rows_.size() - base);
@@ -306,11 +317,17 @@ void Batch64LevelizedMPI::start() {
             }
         }
 
+        // SA0 is only excited where the good value is 1 and SA1 only where it is 0, so one
+        // faulty machine carrying the complemented good value covers both; in the lanes a
+        // fault is not excited the circuit is the good machine.
+        const Word good_eq = simulateFault(base_values, base_ready, expected, kNoFault, Word{0},
+                                           mask, good_values, good_ready);
         for (core::NetId net = 0; net < net_count_; ++net) {
-            const Word eq0 =
-                simulateFault(base_values, base_ready, expected, net, Word{0}, mask, working_values, ready);
-            const Word eq1 =
-                simulateFault(base_values, base_ready, expected, net, mask, mask, working_values, ready);
+            const Word good = good_values[net] & mask;
+            const Word faulty_eq = simulateFault(base_values, base_ready, expected, net,
+                                                 ~good & mask, mask, working_values, ready);
+            const Word eq0 = (faulty_eq & good) | (good_eq & ~good);
+            const Word eq1 = (faulty_eq & ~good) | (good_eq & good);
 
             if (mpi_rank_ == 0) {
                 for (std::size_t offset = 0; offset < chunk_size; ++offset) {
@@ -16,7 +16,8 @@ namespace algorithm {
 class Batch64LevelizedParallel : public FaultSimulator {
 public:
     Batch64LevelizedParallel(const core::Circuit& circuit,
-                             const std::vector<io::PatternRow>& rows);
+                             const std::vector<io::PatternRow>& rows,
+                             int num_threads = 2);
     ~Batch64LevelizedParallel() override = default;
 
     void start() override;
@@ -46,6 +47,7 @@ private:
     std::vector<std::vector<std::size_t>> gates_by_level_;
     int max_level_ = 0;
     std::vector<int> output_index_by_net_;
+    int num_threads_ = 2;
 };
 
 }  // namespace algorithm
@@ -1,5 +1,6 @@
 #include "algorithm/batch64_mt_fault.hpp"
 
+#include <algorithm>
 #include <cstdint>
 #include <limits>
 #include <stdexcept>
@@ -12,50 +13,52 @@ namespace algorithm {
 
 namespace {
 
-uint64_t evaluateGateBits(core::GateType type, const std::vector<uint64_t>& inputs, uint64_t mask) {
+template <typename Fetch>
+uint64_t evaluateGateBits(const core::Gate& gate, Fetch fetch, uint64_t mask) {
+    const auto& inputs = gate.inputs;
     if (inputs.empty()) {
         throw std::runtime_error("Gate missing inputs during 64-bit DFS simulation");
     }
-    switch (type) {
+    switch (gate.type) {
         case core::GateType::And: {
             uint64_t v = mask;
             for (auto in : inputs) {
-                v &= in;
+                v &= fetch(in);
             }
             return v & mask;
         }
         case core::GateType::Nand: {
             uint64_t v = mask;
             for (auto in : inputs) {
-                v &= in;
+                v &= fetch(in);
             }
             return (~v) & mask;
         }
         case core::GateType::Or: {
             uint64_t v = 0;
             for (auto in : inputs) {
-                v |= in;
+                v |= fetch(in);
             }
             return v & mask;
         }
         case core::GateType::Nor: {
             uint64_t v = 0;
             for (auto in : inputs) {
-                v |= in;
+                v |= fetch(in);
             }
             return (~v) & mask;
         }
         case core::GateType::Xor: {
             uint64_t v = 0;
             for (auto in : inputs) {
-                v ^= in;
+                v ^= fetch(in);
             }
             return v & mask;
         }
         case core::GateType::Xnor: {
             uint64_t v = 0;
             for (auto in : inputs) {
-                v ^= in;
+                v ^= fetch(in);
             }
             return (~v) & mask;
         }
@@ -63,65 +66,134 @@ uint64_t evaluateGateBits(core::GateType type, const std::vector<uint64_t>& inpu
             if (inputs.size() != 1) {
                 throw std::runtime_error("NOT gate expects exactly one input");
             }
-            return (~inputs.front()) & mask;
+            return (~fetch(inputs.front())) & mask;
         case core::GateType::Buf:
             if (inputs.size() != 1) {
                 throw std::runtime_error("BUF gate expects exactly one input");
             }
-            return inputs.front() & mask;
+            return fetch(inputs.front()) & mask;
         case core::GateType::Unknown:
         default:
             throw std::runtime_error("Unknown gate type during 64-bit DFS simulation");
     }
 }
 
+// Per-thread scratch space, sized once and reused for every fault of every chunk.
+// A net is resolved for the current fault when its stamp equals `epoch`, so nothing
+// needs to be cleared between faults.
+struct DfsWorkspace {
+    struct Frame {
+        core::NetId net;
+        std::size_t next_input;
+    };
+
+    std::vector<uint64_t> values;
+    std::vector<uint32_t> stamps;
+    std::vector<Frame> stack;
+    uint32_t epoch{0};
+
+    void init(std::size_t net_count) {
+        values.assign(net_count, 0);
+        stamps.assign(net_count, 0);
+        stack.clear();
+        stack.reserve(net_count + 1);
+        epoch = 0;
+    }
+
+    void nextEpoch() {
+        if (++epoch == 0) {
+            std::fill(stamps.begin(), stamps.end(), 0);
+            epoch = 1;
+        }
+    }
+};
+
+// Iterative post-order DFS from `target`. Nets fixed by the chunk (pattern assignments)
+// are read from `base_values`; everything else is computed into the workspace.
 uint64_t dfs(core::NetId target,
              core::NetId fault_wire,
-             bool stuck_at_0,
+             uint64_t fault_value,
              uint64_t mask,
              const core::Circuit& circuit,
              const std::vector<int>& net_to_gate,
-             std::vector<bool>& visited,
-             std::vector<uint64_t>& values) {
-    if (target == fault_wire) {
-        visited[target] = true;
-        values[target] = stuck_at_0 ? uint64_t{0} : mask;
-        return values[target];
-    }
-    if (visited[target]) {
-        return values[target];
-    }
+             const std::vector<uint8_t>& base_fixed,
+             const std::vector<uint64_t>& base_values,
+             DfsWorkspace& ws) {
+    auto lookup = [&](core::NetId net, uint64_t& value) {
+        if (net == fault_wire) {
+            value = fault_value;
+            return true;
+        }
+        if (ws.stamps[net] == ws.epoch) {
+            value = ws.values[net];
+            return true;
+        }
+        if (base_fixed[net]) {
+            value = base_values[net];
+            return true;
+        }
+        return false;
+    };
+    auto fetch = [&](core::NetId net) {
+        uint64_t value = 0;
+        lookup(net, value);
+        return value;
+    };
 
-    const auto net_type = circuit.netType(target);
-    if (net_type == core::NetType::PrimaryInput) {
-        visited[target] = true;
-        return values[target];
+    uint64_t result = 0;
+    if (lookup(target, result)) {
+        return result;
     }
 
-    const int gate_index = net_to_gate[target];
-    if (gate_index < 0) {
-        throw std::runtime_error("Unable to locate driving gate for net during 64-bit DFS");
-    }
+    const auto& gates = circuit.gates();
+    ws.stack.clear();
+    ws.stack.push_back({target, 0});
+    while (!ws.stack.empty()) {
+        auto& frame = ws.stack.back();
+        const int gate_index = net_to_gate[frame.net];
+        if (gate_index < 0) {
+            throw std::runtime_error("Unable to locate driving gate for net during 64-bit DFS");
+        }
+        const auto& gate = gates[static_cast<std::size_t>(gate_index)];
 
-    const auto& gate = circuit.gates()[static_cast<std::size_t>(gate_index)];
-    std::vector<uint64_t> input_values;
-    input_values.reserve(gate.inputs.size());
-    for (auto input_net : gate.inputs) {
-        input_values.push_back(
-            dfs(input_net, fault_wire, stuck_at_0, mask, circuit, net_to_gate, visited, values));
+        bool descended = false;
+        while (frame.next_input < gate.inputs.size()) {
+            const core::NetId input = gate.inputs[frame.next_input++];
+            uint64_t ignored = 0;
+            if (!lookup(input, ignored)) {
+                ws.stack.push_back({input, 0});
+                descended = true;
+                break;
+            }
+        }
+        if (descended) {
+            continue;
+        }
+
+        const core::NetId net = frame.net;
+        ws.values[net] = evaluateGateBits(gate, fetch, mask);
+        ws.stamps[net] = ws.epoch;
+        ws.stack.pop_back();
     }
-    uint64_t result = evaluateGateBits(gate.type, input_values, mask);
-    visited[target] = true;
-    values[target] = result;
-    return result;
+    return ws.values[target];
 }
 
+// Passed as the fault wire to simulate the good machine.
+constexpr core::NetId kNoFault = std::numeric_limits<core::NetId>::max();
+
+struct FaultResultBits {
+    uint64_t stuck0{0};
+    uint64_t stuck1{0};
+};
+
 }  // namespace
 
 Batch64MtFaultSimulator::Batch64MtFaultSimulator(const core::Circuit& circuit,
                                                  const std::vector<io::PatternRow>& rows,
                                                  int num_threads)
-    : FaultSimulator(circuit, rows), num_threads_(num_threads) {
+    : FaultSimulator(circuit, rows),
+      observability_(core::analyzeObservability(circuit)),
+      num_threads_(num_threads) {
     net_to_gate_.assign(circuit_.netCount(), -1);
     for (std::size_t i = 0; i < circuit_.gates().size(); ++i) {
         net_to_gate_[circuit_.gates()[i].output] = static_cast<int>(i);
@@ -139,20 +211,37 @@ void Batch64MtFaultSimulator::start() {
     if (num_threads_ > 0) {
         omp_set_num_threads(num_threads_);
     }
+    const int thread_count = std::max(1, omp_get_max_threads());
+#else
+    const int thread_count = 1;
 #endif
 
     const auto& outputs = circuit_.primaryOutputs();
     const std::size_t net_count = circuit_.netCount();
 
+    std::vector<DfsWorkspace> workspaces(static_cast<std::size_t>(thread_count));
+    for (auto& ws : workspaces) {
+        ws.init(net_count);
+    }
+
+    std::vector<uint64_t> base_values(net_count, 0);
+    std::vector<uint8_t> base_fixed(net_count, 0);
+    std::vector<uint64_t> provided_value(outputs.size(), 0);
+    std::vector<uint64_t> good_output_eq(outputs.size(), 0);
+    std::vector<FaultResultBits> fault_bits(net_count);
+    std::vector<uint64_t> good_values(net_count, 0);
+
     for (std::size_t base = 0; base < rows_.size(); base += 64) {
         const std::size_t chunk_size = std::min<std::size_t>(64, rows_.size() - base);
         const uint64_t mask =
             (chunk_size == 64) ? std::numeric_limits<uint64_t>::max()
                                : ((uint64_t{1} << chunk_size) - 1);
 
-        std::vector<uint64_t> base_values(net_count, 0);
-        std::vector<bool> base_visited(net_count, false);
-
+        std::fill(base_values.begin(), base_values.end(), 0);
+        std::fill(base_fixed.begin(), base_fixed.end(), 0);
+        for (auto pi : circuit_.primaryInputs()) {
+            base_fixed[pi] = 1;
+        }
         for (std::size_t offset = 0; offset < chunk_size; ++offset) {
             const uint64_t bit = uint64_t{1} << offset;
             const auto& assignments = rows_[base + offset].pattern.assignments;
@@ -160,11 +249,11 @@ void Batch64MtFaultSimulator::start() {
                 if (entry.value) {
                     base_values[entry.net] |= bit;
                 }
-                base_visited[entry.net] = true;
+                base_fixed[entry.net] = 1;
             }
         }
 
-        std::vector<uint64_t> provided_value(outputs.size(), 0);
+        std::fill(provided_value.begin(), provided_value.end(), 0);
         for (std::size_t offset = 0; offset < chunk_size; ++offset) {
             const uint64_t bit = uint64_t{1} << offset;
             const auto& provided = rows_[base + offset].provided_outputs;
@@ -179,40 +268,59 @@ void Batch64MtFaultSimulator::start() {
             }
         }
 
-        struct FaultResultBits {
-            uint64_t stuck0{0};
-            uint64_t stuck1{0};
-        };
-        std::vector<FaultResultBits> fault_bits(net_count);
+        // Good machine, resolved from the outputs in one epoch. Nets outside every output cone
+        // stay 0: a fault there cannot reach an output, so the value injected does not matter.
+        DfsWorkspace& good_ws = workspaces.front();
+        good_ws.nextEpoch();
+        uint64_t good_eq = mask;
+        for (std::size_t i = 0; i < outputs.size(); ++i) {
+            const uint64_t out = dfs(outputs[i], kNoFault, 0, mask, circuit_, net_to_gate_,
+                                     base_fixed, base_values, good_ws);
+            good_output_eq[i] = ~(out ^ provided_value[i]) & mask;
+            good_eq &= good_output_eq[i];
+        }
+        for (std::size_t net = 0; net < net_count; ++net) {
+            good_values[net] = good_ws.stamps[net] == good_ws.epoch ? good_ws.values[net]
+                               : base_fixed[net]                     ? base_values[net]
+                                                                     : 0;
+        }
 
 #pragma omp parallel for schedule(static)
         for (long long net = 0; net < static_cast<long long>(net_count); ++net) {
-            auto computeOutputs = [&](bool stuck_at_0) {
-                std::vector<uint64_t> values = base_values;
-                std::vector<bool> visited = base_visited;
-                if (static_cast<std::size_t>(net) < values.size()) {
-                    values[static_cast<std::size_t>(net)] = stuck_at_0 ? uint64_t{0} : mask;
-                    visited[static_cast<std::size_t>(net)] = true;
-                }
-                std::vector<uint64_t> outs(outputs.size(), 0);
-                for (std::size_t i = 0; i < outputs.size(); ++i) {
-                    outs[i] = dfs(outputs[i], static_cast<core::NetId>(net), stuck_at_0, mask,
-                                  circuit_, net_to_gate_, visited, values);
-                }
-                return outs;
-            };
-
-            const auto outs0 = computeOutputs(true);
-            const auto outs1 = computeOutputs(false);
+#ifdef _OPENMP
+            DfsWorkspace& ws = workspaces[static_cast<std::size_t>(omp_get_thread_num())];
+#else
+            DfsWorkspace& ws = workspaces.front();
+#endif
+            const auto fault_wire = static_cast<core::NetId>(net);
+            const uint64_t good = good_values[static_cast<std::size_t>(net)] & mask;
+            auto& bits = fault_bits[static_cast<std::size_t>(net)];
+            if (!observability_.observable[fault_wire]) {
+                bits.stuck0 = good_eq;
+                bits.stuck1 = good_eq;
+                continue;
+            }
 
-            uint64_t eq0 = mask;
-            uint64_t eq1 = mask;
-            for (std::size_t i = 0; i < outputs.size(); ++i) {
-                eq0 &= ~(outs0[i] ^ provided_value[i]) & mask;
-                eq1 &= ~(outs1[i] ^ provided_value[i]) & mask;
+            // SA0 is only excited where the good value is 1 and SA1 only where it is 0, so a
+            // single faulty machine carrying the complemented good value covers both. In the
+            // lanes a fault is not excited the circuit is the good machine, and so are the
+            // outputs the fault has no path to. Outputs are folded into the equality word as
+            // they resolve; once every lane differs there is nothing left to learn from the
+            // remaining outputs.
+            ws.nextEpoch();
+            uint64_t faulty_eq = mask;
+            for (std::size_t i = 0; i < outputs.size() && faulty_eq != 0; ++i) {
+                if (!observability_.reaches(fault_wire, i)) {
+                    faulty_eq &= good_output_eq[i];
+                    continue;
+                }
+                const uint64_t out = dfs(outputs[i], fault_wire, ~good & mask, mask, circuit_,
+                                         net_to_gate_, base_fixed, base_values, ws);
+                faulty_eq &= ~(out ^ provided_value[i]) & mask;
             }
-            fault_bits[static_cast<std::size_t>(net)].stuck0 = eq0;
-            fault_bits[static_cast<std::size_t>(net)].stuck1 = eq1;
+
+            bits.stuck0 = (faulty_eq & good) | (good_eq & ~good);
+            bits.stuck1 = (faulty_eq & ~good) | (good_eq & good);
         }
 
         for (std::size_t net = 0; net < net_count; ++net) {
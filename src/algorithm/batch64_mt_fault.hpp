@@ -2,6 +2,7 @@
 
 #include "algorithm/fault_simulator.hpp"
 #include "core/circuit.hpp"
+#include "core/observability.hpp"
 #include <vector>
 
 namespace algorithm {
@@ -18,6 +19,7 @@ public:
 private:
     std::vector<int> net_to_gate_;
     std::vector<int> output_index_by_net_;
+    core::Observability observability_;
     int num_threads_{4};
 };
 
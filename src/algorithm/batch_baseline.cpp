@@ -103,7 +103,7 @@ int dfs(core::NetId target,
 
 BatchBaselineSimulator::BatchBaselineSimulator(const core::Circuit& circuit,
                                                const std::vector<io::PatternRow>& rows)
-    : FaultSimulator(circuit, rows) {
+    : FaultSimulator(circuit, rows), observability_(core::analyzeObservability(circuit, 0)) {
     net_to_gate_.assign(circuit_.netCount(), -1);
     const auto& gates = circuit_.gates();
     for (std::size_t i = 0; i < gates.size(); ++i) {
@@ -143,8 +143,16 @@ bool BatchBaselineSimulator::simulate(std::size_t pattern_id,
 void BatchBaselineSimulator::start() {
     for (std::size_t pattern_id = 0; pattern_id < rows_.size(); ++pattern_id) {
         std::unordered_map<core::NetId, int> reference_outputs = rows_[pattern_id].provided_outputs;
+        // A fault with no path to an output leaves every output at its good value.
+        const bool good_eq = simulate(pattern_id, std::numeric_limits<core::NetId>::max(), true,
+                                      reference_outputs);
 
         for (core::NetId net = 0; net < circuit_.netCount(); ++net) {
+            if (!observability_.observable[net]) {
+                answers.set(pattern_id, net, true, good_eq);
+                answers.set(pattern_id, net, false, good_eq);
+                continue;
+            }
             const bool stuck0_eq = simulate(pattern_id, net, true, reference_outputs);
             const bool stuck1_eq = simulate(pattern_id, net, false, reference_outputs);
             answers.set(pattern_id, net, true, stuck0_eq);
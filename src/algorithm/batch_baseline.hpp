@@ -1,12 +1,13 @@
-#pragma once
-
-#include "algorithm/fault_simulator.hpp"
-#include "core/circuit.hpp"
-#include <vector>
-
-namespace algorithm {
-
-class BatchBaselineSimulator : public FaultSimulator {
+#pragma once
+
+#include "algorithm/fault_simulator.hpp"
+#include "core/circuit.hpp"
+#include "core/observability.hpp"
+#include <vector>
+
+namespace algorithm {
+
+class BatchBaselineSimulator : public FaultSimulator {
 public:
     BatchBaselineSimulator(const core::Circuit& circuit, const std::vector<io::PatternRow>& rows);
     ~BatchBaselineSimulator() override = default;
@@ -16,6 +17,7 @@ public:
 
 private:
     std::vector<int> net_to_gate_;
+    core::Observability observability_;
 };
 
 }
@@ -1,10 +1,16 @@
 #include "algorithm/bit_parallel_simulator.hpp"
 
 #include <algorithm>
+#include <bit>
 #include <cstdint>
+#include <exception>
 #include <limits>
 #include <stdexcept>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace algorithm {
 
 namespace {
@@ -36,31 +42,246 @@ uint64_t xorReduce(const std::vector<uint64_t>& values, const std::vector<std::s
     return result & mask;
 }
 
+// Faulty machines simulated together by simulatePatternBlocks(); 8 x 64 bits fills one
+// 512-bit vector register, and plain loops over the slots are what the compiler vectorizes.
+constexpr std::size_t kFaultSlots = 8;
+
+struct SlotWords {
+    uint64_t slot[kFaultSlots];
+
+    static SlotWords broadcast(uint64_t word) {
+        SlotWords result;
+        std::fill(std::begin(result.slot), std::end(result.slot), word);
+        return result;
+    }
+    SlotWords& operator&=(const SlotWords& other) {
+        for (std::size_t j = 0; j < kFaultSlots; ++j) {
+            slot[j] &= other.slot[j];
+        }
+        return *this;
+    }
+    SlotWords& operator|=(const SlotWords& other) {
+        for (std::size_t j = 0; j < kFaultSlots; ++j) {
+            slot[j] |= other.slot[j];
+        }
+        return *this;
+    }
+    SlotWords& operator^=(const SlotWords& other) {
+        for (std::size_t j = 0; j < kFaultSlots; ++j) {
+            slot[j] ^= other.slot[j];
+        }
+        return *this;
+    }
+    SlotWords operator~() const {
+        SlotWords result;
+        for (std::size_t j = 0; j < kFaultSlots; ++j) {
+            result.slot[j] = ~slot[j];
+        }
+        return result;
+    }
+    bool allEqual(uint64_t word) const {
+        uint64_t diff = 0;
+        for (std::size_t j = 0; j < kFaultSlots; ++j) {
+            diff |= slot[j] ^ word;
+        }
+        return diff == 0;
+    }
+};
+
+// Works for plain words (the good machine) and SlotWords (faulty machines) alike.
+template <typename Value, typename Fetch>
+Value evaluateGate(const core::Gate& gate, Fetch fetch) {
+    const auto& inputs = gate.inputs;
+    if (inputs.empty()) {
+        throw std::runtime_error("Gate missing inputs during simulation");
+    }
+    Value result = fetch(inputs.front());
+    switch (gate.type) {
+        case core::GateType::And:
+        case core::GateType::Nand:
+            for (std::size_t i = 1; i < inputs.size(); ++i) {
+                result &= fetch(inputs[i]);
+            }
+            break;
+        case core::GateType::Or:
+        case core::GateType::Nor:
+            for (std::size_t i = 1; i < inputs.size(); ++i) {
+                result |= fetch(inputs[i]);
+            }
+            break;
+        case core::GateType::Xor:
+        case core::GateType::Xnor:
+            for (std::size_t i = 1; i < inputs.size(); ++i) {
+                result ^= fetch(inputs[i]);
+            }
+            break;
+        case core::GateType::Not:
+        case core::GateType::Buf:
+            if (inputs.size() != 1) {
+                throw std::runtime_error("NOT/BUF gate expects exactly one input");
+            }
+            break;
+        case core::GateType::Unknown:
+        default:
+            throw std::runtime_error("Unknown gate type encountered during simulation");
+    }
+    if (gate.type == core::GateType::Nand || gate.type == core::GateType::Nor ||
+        gate.type == core::GateType::Xnor || gate.type == core::GateType::Not) {
+        result = ~result;
+    }
+    return result;
+}
+
+// Per-thread state of simulatePatternBlocks(). A net holds faulty values for the current
+// fault group only when its stamp equals `epoch`; otherwise it equals the good machine.
+struct BlockWorkspace {
+    std::vector<uint64_t> good;
+    std::vector<SlotWords> values;
+    std::vector<uint32_t> stamps;
+    uint32_t epoch{0};
+    std::vector<int> slot_of_net;
+    // One bit per topological position. Scheduled gates always sit after the one being
+    // evaluated, so a forward scan visits them in dependency order.
+    std::vector<uint64_t> pending;
+    std::vector<core::NetId> touched_outputs;
+
+    void init(std::size_t net_count, std::size_t gate_count) {
+        good.assign(net_count, 0);
+        values.resize(net_count);
+        stamps.assign(net_count, 0);
+        epoch = 0;
+        slot_of_net.assign(net_count, -1);
+        pending.assign((gate_count + 63) / 64, 0);
+    }
+
+    void nextEpoch() {
+        if (++epoch == 0) {
+            std::fill(stamps.begin(), stamps.end(), 0);
+            epoch = 1;
+        }
+    }
+};
+
 }  // namespace
 
 BitParallelSimulator::BitParallelSimulator(const core::Circuit& circuit,
-                                           const std::vector<io::PatternRow>& rows)
-    : FaultSimulator(circuit, rows), circuit_(circuit) {
+                                           const std::vector<io::PatternRow>& rows,
+                                           int num_threads)
+    : FaultSimulator(circuit, rows),
+      circuit_(circuit),
+      observable_(core::analyzeObservability(circuit, 0).observable),
+      folded_(core::simplifyCircuit(circuit)),
+      folded_observability_(core::analyzeObservability(folded_.circuit, 0)),
+      num_threads_(num_threads) {
     output_indices_ = circuit_.primaryOutputs();
+
+    const std::size_t net_count = folded_.circuit.netCount();
+    aliased_begin_.assign(net_count + 1, 0);
+    for (const auto& alias : folded_.alias) {
+        ++aliased_begin_[alias.net + 1];
+    }
+    for (std::size_t net = 0; net < net_count; ++net) {
+        aliased_begin_[net + 1] += aliased_begin_[net];
+    }
+    aliased_nets_.resize(folded_.alias.size());
+    std::vector<std::size_t> fill(aliased_begin_.begin(), aliased_begin_.end() - 1);
+    for (core::NetId net = 0; net < folded_.alias.size(); ++net) {
+        aliased_nets_[fill[folded_.alias[net].net]++] = net;
+    }
+
+    const auto& gates = folded_.circuit.gates();
+    std::vector<int> driver(net_count, -1);
+    for (std::size_t i = 0; i < gates.size(); ++i) {
+        driver[gates[i].output] = static_cast<int>(i);
+    }
+    fanout_gates_.assign(net_count, {});
+    std::vector<std::size_t> pending(gates.size(), 0);
+    for (std::size_t i = 0; i < gates.size(); ++i) {
+        for (const core::NetId net : gates[i].inputs) {
+            fanout_gates_[net].push_back(i);
+            if (driver[net] >= 0) {
+                ++pending[i];
+            }
+        }
+    }
+    for (std::size_t i = 0; i < gates.size(); ++i) {
+        if (pending[i] == 0) {
+            topo_order_.push_back(i);
+        }
+    }
+    for (std::size_t head = 0; head < topo_order_.size(); ++head) {
+        for (const std::size_t next : fanout_gates_[gates[topo_order_[head]].output]) {
+            if (--pending[next] == 0) {
+                topo_order_.push_back(next);
+            }
+        }
+    }
+    if (topo_order_.size() != gates.size()) {
+        topo_order_.clear();
+        return;
+    }
+    topo_position_.assign(gates.size(), 0);
+    for (std::size_t pos = 0; pos < topo_order_.size(); ++pos) {
+        topo_position_[topo_order_[pos]] = pos;
+    }
+    is_output_.assign(net_count, 0);
+    for (const auto po : folded_.circuit.primaryOutputs()) {
+        is_output_[po] = 1;
+    }
+    for (auto& readers : fanout_gates_) {
+        std::erase_if(readers, [&](std::size_t gate_index) {
+            return !folded_observability_.gate_observable[gate_index];
+        });
+    }
+    for (core::NetId net = 0; net < net_count; ++net) {
+        if (folded_observability_.observable[net]) {
+            observed_nets_.push_back(net);
+        }
+    }
 }
 
 std::vector<FaultEvaluation> BitParallelSimulator::evaluate(const core::Pattern& pattern) const {
     if (net_names_.empty()) {
         return {};
     }
-    const std::size_t total_faults = net_names_.size() * 2;
+    // Unobservable nets keep the default evaluation: equal, never potentially detected.
+    std::vector<ChunkFault> faults;
+    for (std::size_t net_index = 0; net_index < net_names_.size(); ++net_index) {
+        if (observable_[net_index]) {
+            faults.push_back({net_index, 0});
+            faults.push_back({net_index, 1});
+        }
+    }
+    const std::size_t total_faults = faults.size();
     std::vector<FaultEvaluation> evaluations(net_names_.size());
+    const bool has_x = std::any_of(pattern.assignments.begin(), pattern.assignments.end(),
+                                   [](const core::PatternEntry& entry) {
+                                       return entry.value == core::kValueX;
+                                   });
     std::size_t processed = 0;
     while (processed < total_faults) {
         const std::size_t remaining = total_faults - processed;
         const std::size_t chunk_faults = std::min<std::size_t>(63, remaining);
-        std::vector<ChunkFault> chunk;
-        chunk.reserve(chunk_faults);
-        for (std::size_t i = 0; i < chunk_faults; ++i) {
-            const std::size_t fault_index = processed + i;
-            const std::size_t net_index = fault_index / 2;
-            const int stuck_value = (fault_index % 2 == 0) ? 0 : 1;
-            chunk.push_back({net_index, stuck_value});
+        const std::vector<ChunkFault> chunk(
+            faults.begin() + static_cast<std::ptrdiff_t>(processed),
+            faults.begin() + static_cast<std::ptrdiff_t>(processed + chunk_faults));
+        if (has_x) {
+            const auto outcomes = simulateChunkDualRail(pattern, chunk);
+            for (std::size_t i = 0; i < chunk.size(); ++i) {
+                const auto& fault = chunk[i];
+                auto& evaluation = evaluations[fault.net_index];
+                const bool equal = outcomes[i] != ChunkOutcome::Detected;
+                const bool potential = outcomes[i] == ChunkOutcome::Potential;
+                if (fault.stuck_value == 0) {
+                    evaluation.stuck0_eq = equal;
+                    evaluation.stuck0_potential = potential;
+                } else {
+                    evaluation.stuck1_eq = equal;
+                    evaluation.stuck1_potential = potential;
+                }
+            }
+            processed += chunk_faults;
+            continue;
         }
         auto chunk_results = simulateChunk(pattern, chunk);
         for (std::size_t i = 0; i < chunk.size(); ++i) {
@@ -183,7 +404,293 @@ std::vector<bool> BitParallelSimulator::simulateChunk(
     return chunk_results;
 }
 
+std::vector<BitParallelSimulator::ChunkOutcome> BitParallelSimulator::simulateChunkDualRail(
+    const core::Pattern& pattern, const std::vector<ChunkFault>& chunk) const {
+    if (chunk.empty()) {
+        return {};
+    }
+
+    const std::size_t net_count = net_names_.size();
+    const std::size_t chunk_bits = chunk.size() + 1;  // include golden context
+    const uint64_t mask =
+        (chunk_bits >= 64) ? std::numeric_limits<uint64_t>::max()
+                           : ((uint64_t{1} << chunk_bits) - 1);
+
+    // ones[n] / zeros[n] hold the lanes where net n is known 1 / known 0; neither means X.
+    std::vector<uint64_t> ones(net_count, 0);
+    std::vector<uint64_t> zeros(net_count, 0);
+    std::vector<uint64_t> force_zero(net_count, 0);
+    std::vector<uint64_t> force_one(net_count, 0);
+
+    auto applyForcing = [&](std::size_t index) {
+        ones[index] = (ones[index] & ~force_zero[index]) | force_one[index];
+        zeros[index] = (zeros[index] & ~force_one[index]) | force_zero[index];
+    };
+
+    for (std::size_t i = 0; i < chunk.size(); ++i) {
+        const uint64_t bit = uint64_t{1} << (i + 1);
+        const auto& fault = chunk[i];
+        if (fault.stuck_value == 0) {
+            force_zero[fault.net_index] |= bit;
+        } else {
+            force_one[fault.net_index] |= bit;
+        }
+    }
+
+    for (const auto& entry : pattern.assignments) {
+        const std::size_t idx = entry.net;
+        if (idx >= net_count) {
+            throw std::runtime_error("Pattern references unknown net");
+        }
+        ones[idx] = entry.value == 1 ? mask : 0;
+        zeros[idx] = entry.value == 0 ? mask : 0;
+        applyForcing(idx);
+    }
+
+    for (const auto& gate : circuit_.gates()) {
+        const auto& input_indices = gate.inputs;
+        uint64_t one = 0;
+        uint64_t zero = 0;
+        switch (gate.type) {
+            case core::GateType::And:
+            case core::GateType::Nand:
+                one = mask;
+                for (auto idx : input_indices) {
+                    one &= ones[idx];
+                    zero |= zeros[idx];
+                }
+                break;
+            case core::GateType::Or:
+            case core::GateType::Nor:
+                zero = mask;
+                for (auto idx : input_indices) {
+                    one |= ones[idx];
+                    zero &= zeros[idx];
+                }
+                break;
+            case core::GateType::Xor:
+            case core::GateType::Xnor:
+                zero = mask;
+                for (auto idx : input_indices) {
+                    const uint64_t next_one = (one & zeros[idx]) | (zero & ones[idx]);
+                    zero = (one & ones[idx]) | (zero & zeros[idx]);
+                    one = next_one;
+                }
+                break;
+            case core::GateType::Not:
+            case core::GateType::Buf:
+                if (input_indices.size() != 1) {
+                    throw std::runtime_error(gate.type == core::GateType::Not
+                                                 ? "NOT gate expects exactly one input"
+                                                 : "BUF gate expects exactly one input");
+                }
+                one = ones[input_indices.front()];
+                zero = zeros[input_indices.front()];
+                break;
+            case core::GateType::Unknown:
+            default:
+                throw std::runtime_error("Unknown gate type encountered during simulation");
+        }
+        if (gate.type == core::GateType::Nand || gate.type == core::GateType::Nor ||
+            gate.type == core::GateType::Xnor || gate.type == core::GateType::Not) {
+            std::swap(one, zero);
+        }
+        const std::size_t out_idx = gate.output;
+        ones[out_idx] = one & mask;
+        zeros[out_idx] = zero & mask;
+        applyForcing(out_idx);
+    }
+
+    // A lane is detected where a known golden output has the opposite known value, and
+    // potentially detected where it became X instead.
+    uint64_t detected = 0;
+    uint64_t potential = 0;
+    for (auto idx : output_indices_) {
+        const uint64_t unknown = ~(ones[idx] | zeros[idx]) & mask;
+        if (ones[idx] & uint64_t{1}) {
+            detected |= zeros[idx];
+            potential |= unknown;
+        } else if (zeros[idx] & uint64_t{1}) {
+            detected |= ones[idx];
+            potential |= unknown;
+        }
+    }
+
+    std::vector<ChunkOutcome> outcomes(chunk.size(), ChunkOutcome::Equal);
+    for (std::size_t i = 0; i < chunk.size(); ++i) {
+        const uint64_t bit = uint64_t{1} << (i + 1);
+        if (detected & bit) {
+            outcomes[i] = ChunkOutcome::Detected;
+        } else if (potential & bit) {
+            outcomes[i] = ChunkOutcome::Potential;
+        }
+    }
+    return outcomes;
+}
+
+void BitParallelSimulator::simulatePatternBlocks() {
+    const auto& gates = folded_.circuit.gates();
+    const std::size_t net_count = folded_.circuit.netCount();
+    const std::size_t block_count = (rows_.size() + 63) / 64;
+    std::exception_ptr failure;
+
+#pragma omp parallel
+    {
+        BlockWorkspace ws;
+        ws.init(net_count, gates.size());
+        auto fetch = [&](core::NetId net) {
+            return ws.stamps[net] == ws.epoch ? ws.values[net] : SlotWords::broadcast(ws.good[net]);
+        };
+        auto schedule = [&](core::NetId changed) {
+            for (const std::size_t gate_index : fanout_gates_[changed]) {
+                const std::size_t pos = topo_position_[gate_index];
+                ws.pending[pos / 64] |= uint64_t{1} << (pos % 64);
+            }
+        };
+
+        // Good machine of patterns [first, first + count), one lane per pattern.
+        auto simulateGood = [&](std::size_t first, std::size_t count) {
+            std::fill(ws.good.begin(), ws.good.end(), 0);
+            for (std::size_t lane = 0; lane < count; ++lane) {
+                for (const auto& entry : rows_[first + lane].pattern.assignments) {
+                    if (entry.net >= folded_.alias.size()) {
+                        throw std::runtime_error("Pattern references unknown net");
+                    }
+                    // Primary inputs are never folded away, so this is a renumbering.
+                    if (entry.value) {
+                        ws.good[folded_.alias[entry.net].net] |= uint64_t{1} << lane;
+                    }
+                }
+            }
+            for (const std::size_t gate_index : topo_order_) {
+                if (!folded_observability_.gate_observable[gate_index]) {
+                    continue;
+                }
+                const auto& gate = gates[gate_index];
+                ws.good[gate.output] =
+                    evaluateGate<uint64_t>(gate, [&](core::NetId net) { return ws.good[net]; });
+            }
+        };
+
+        // Slot j carries net nets[j] at its complemented good value: SA0 in the lanes where
+        // the net is 1 and SA1 where it is 0, so one pass grades both faults. Only gates whose
+        // inputs differ from the good machine in some slot are evaluated. Returns, per slot,
+        // the lanes in which a primary output differs.
+        auto simulateGroup = [&](const core::NetId* nets, std::size_t slots,
+                                 uint64_t (&detected)[kFaultSlots]) {
+            ws.nextEpoch();
+            for (std::size_t j = 0; j < slots; ++j) {
+                const core::NetId net = nets[j];
+                ws.slot_of_net[net] = static_cast<int>(j);
+                SlotWords injected = SlotWords::broadcast(ws.good[net]);
+                injected.slot[j] = ~ws.good[net];
+                ws.values[net] = injected;
+                ws.stamps[net] = ws.epoch;
+                if (is_output_[net]) {
+                    ws.touched_outputs.push_back(net);
+                }
+                schedule(net);
+            }
+            std::size_t word = 0;
+            while (true) {
+                while (word < ws.pending.size() && ws.pending[word] == 0) {
+                    ++word;
+                }
+                if (word == ws.pending.size()) {
+                    break;
+                }
+                const int bit = std::countr_zero(ws.pending[word]);
+                ws.pending[word] &= ws.pending[word] - 1;
+                const std::size_t pos = word * 64 + static_cast<std::size_t>(bit);
+                const auto& gate = gates[topo_order_[pos]];
+                const core::NetId out = gate.output;
+                SlotWords value = evaluateGate<SlotWords>(gate, fetch);
+                const int forced = ws.slot_of_net[out];
+                if (forced >= 0) {
+                    value.slot[forced] = ~ws.good[out];
+                } else if (value.allEqual(ws.good[out])) {
+                    continue;
+                }
+                ws.values[out] = value;
+                ws.stamps[out] = ws.epoch;
+                if (is_output_[out] && forced < 0) {
+                    ws.touched_outputs.push_back(out);
+                }
+                schedule(out);
+            }
+
+            std::fill(std::begin(detected), std::end(detected), 0);
+            for (const core::NetId po : ws.touched_outputs) {
+                for (std::size_t j = 0; j < slots; ++j) {
+                    detected[j] |= ws.values[po].slot[j] ^ ws.good[po];
+                }
+            }
+            ws.touched_outputs.clear();
+            for (std::size_t j = 0; j < slots; ++j) {
+                ws.slot_of_net[nets[j]] = -1;
+            }
+        };
+
+        // Blocks are disjoint pattern ranges, so each answer row is written by one thread.
+#pragma omp for schedule(dynamic)
+        for (long long b = 0; b < static_cast<long long>(block_count); ++b) {
+            const std::size_t first = static_cast<std::size_t>(b) * 64;
+            const std::size_t count = std::min<std::size_t>(64, rows_.size() - first);
+            // `detected` holds the lanes in which the folded net's fault reaches an output.
+            auto record = [&](core::NetId net, uint64_t detected) {
+                const uint64_t hits[2] = {detected & ws.good[net], detected & ~ws.good[net]};
+                // SA<v> on an original net is SA<v ^ inverted> on the folded one.
+                for (std::size_t k = aliased_begin_[net]; k < aliased_begin_[net + 1]; ++k) {
+                    const core::NetId original = aliased_nets_[k];
+                    const bool inverted = folded_.alias[original].inverted;
+                    const uint64_t stuck0_hits = hits[inverted ? 1 : 0];
+                    const uint64_t stuck1_hits = hits[inverted ? 0 : 1];
+                    for (std::size_t lane = 0; lane < count; ++lane) {
+                        answers.set(first + lane, original, true,
+                                    ((stuck0_hits >> lane) & 1U) == 0);
+                        answers.set(first + lane, original, false,
+                                    ((stuck1_hits >> lane) & 1U) == 0);
+                    }
+                }
+            };
+            try {
+                simulateGood(first, count);
+                uint64_t detected[kFaultSlots];
+                for (std::size_t group = 0; group < observed_nets_.size();
+                     group += kFaultSlots) {
+                    const std::size_t slots =
+                        std::min(kFaultSlots, observed_nets_.size() - group);
+                    simulateGroup(&observed_nets_[group], slots, detected);
+                    for (std::size_t j = 0; j < slots; ++j) {
+                        record(observed_nets_[group + j], detected[j]);
+                    }
+                }
+                for (core::NetId net = 0; net < net_count; ++net) {
+                    if (!folded_observability_.observable[net]) {
+                        record(net, 0);
+                    }
+                }
+            } catch (...) {
+#pragma omp critical
+                failure = std::current_exception();
+            }
+        }
+    }
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+}
+
 void BitParallelSimulator::start() {
+#ifdef _OPENMP
+    if (num_threads_ > 0) {
+        omp_set_num_threads(num_threads_);
+    }
+#endif
+    if (!topo_order_.empty() && !io::hasUnknownValues(rows_)) {
+        simulatePatternBlocks();
+        return;
+    }
     for (std::size_t i = 0; i < rows_.size(); ++i) {
         const auto evaluations = evaluate(rows_[i].pattern);
         if (evaluations.size() != net_names_.size()) {
@@ -192,6 +699,12 @@ void BitParallelSimulator::start() {
         for (std::size_t net_id = 0; net_id < evaluations.size(); ++net_id) {
             answers.set(i, net_id, true, evaluations[net_id].stuck0_eq);
             answers.set(i, net_id, false, evaluations[net_id].stuck1_eq);
+            if (evaluations[net_id].stuck0_potential) {
+                answers.setPotential(i, net_id, true);
+            }
+            if (evaluations[net_id].stuck1_potential) {
+                answers.setPotential(i, net_id, false);
+            }
         }
     }
 }
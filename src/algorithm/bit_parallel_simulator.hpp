@@ -1,21 +1,27 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
 #include "algorithm/fault_simulator.hpp"
 #include "core/circuit.hpp"
+#include "core/circuit_simplifier.hpp"
+#include "core/observability.hpp"
 #include "core/pattern_generator.hpp"
 
 namespace algorithm {
 
 class BitParallelSimulator : public FaultSimulator {
 public:
-    BitParallelSimulator(const core::Circuit& circuit, const std::vector<io::PatternRow>& rows);
+    // num_threads <= 0 leaves the OpenMP default in place.
+    BitParallelSimulator(const core::Circuit& circuit, const std::vector<io::PatternRow>& rows,
+                         int num_threads = 0);
     ~BitParallelSimulator() override = default;
 
     std::vector<FaultEvaluation> evaluate(const core::Pattern& pattern) const;
     void start() override;
+    bool supportsUnknownValues() const override { return true; }
 
 private:
     struct ChunkFault {
@@ -23,11 +29,40 @@ private:
         int stuck_value{};
     };
 
+    enum class ChunkOutcome : std::uint8_t { Equal, Detected, Potential };
+
+    // X-free rows use 2D packing instead: 64 patterns per word and kFaultSlots faulty
+    // machines per pass, each differing from the block's good machine only inside its
+    // fault's fanout cone. This path grades the BUF/NOT-folded circuit and copies each
+    // result to the original nets aliasing it. Only observable nets are graded.
+    void simulatePatternBlocks();
+
     std::vector<bool> simulateChunk(const core::Pattern& pattern,
                                     const std::vector<ChunkFault>& chunk) const;
+    // Same lanes as simulateChunk, but every net carries two words (known-1, known-0) so
+    // patterns with X inputs are simulated in 0/1/X logic.
+    std::vector<ChunkOutcome> simulateChunkDualRail(const core::Pattern& pattern,
+                                                    const std::vector<ChunkFault>& chunk) const;
 
     const core::Circuit& circuit_;
     std::vector<std::size_t> output_indices_;
+    // Faults on nets outside every output cone are never simulated, on either path.
+    std::vector<std::uint8_t> observable_;
+    core::SimplifiedCircuit folded_;
+    core::Observability folded_observability_;
+    std::vector<core::NetId> observed_nets_;
+    // Original nets grouped by the folded net they alias: folded net n stands for
+    // aliased_nets_[aliased_begin_[n] .. aliased_begin_[n + 1]).
+    std::vector<std::size_t> aliased_begin_;
+    std::vector<core::NetId> aliased_nets_;
+    // Over the folded circuit: gates in dependency order, each gate's position in it, and
+    // the observable gates reading each net. Left empty when the circuit has a loop; such circuits stay
+    // on the per-pattern path.
+    std::vector<std::size_t> topo_order_;
+    std::vector<std::size_t> topo_position_;
+    std::vector<std::vector<std::size_t>> fanout_gates_;
+    std::vector<std::uint8_t> is_output_;
+    int num_threads_{0};
 };
 
 }  // namespace algorithm
@@ -0,0 +1,59 @@
+#include "algorithm/checkpointed_simulator.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+#include "io/checkpoint_file.hpp"
+
+namespace algorithm {
+
+CheckpointedSimulator::CheckpointedSimulator(const core::Circuit& circuit,
+                                             const std::vector<io::PatternRow>& rows,
+                                             Factory factory, Options options)
+    : FaultSimulator(circuit, rows), factory_(std::move(factory)), options_(std::move(options)) {
+    if (options_.chunk_patterns == 0) {
+        throw std::invalid_argument("Checkpoint chunk size must be positive");
+    }
+}
+
+void CheckpointedSimulator::start() {
+    io::CheckpointHeader header;
+    header.circuit_hash = io::hashCircuit(circuit_);
+    header.pattern_hash = io::hashPatterns(rows_);
+    header.net_count = net_names_.size();
+    header.pattern_count = rows_.size();
+
+    std::size_t next = 0;
+    std::optional<io::CheckpointWriter> writer;
+    if (options_.resume && std::filesystem::exists(options_.path)) {
+        const auto state = io::loadCheckpoint(options_.path, header, answers);
+        next = state.completed_patterns;
+        writer.emplace(options_.path, header, state.valid_bytes);
+        std::cerr << "Resuming from checkpoint: " << next << " of " << rows_.size()
+                  << " patterns done\n";
+    } else {
+        writer.emplace(options_.path, header);
+    }
+
+    std::vector<io::PatternRow> chunk_rows;
+    while (next < rows_.size()) {
+        const std::size_t count = std::min(options_.chunk_patterns, rows_.size() - next);
+        chunk_rows.assign(rows_.begin() + static_cast<std::ptrdiff_t>(next),
+                          rows_.begin() + static_cast<std::ptrdiff_t>(next + count));
+
+        auto engine = factory_(circuit_, chunk_rows);
+        engine->start();
+        for (std::size_t i = 0; i < count; ++i) {
+            answers.setRow(next + i, engine->answers.get(i));
+        }
+        writer->appendChunk(answers, next, count);
+        next += count;
+        std::cerr << "Checkpointed " << next << " of " << rows_.size() << " patterns\n";
+    }
+}
+
+}  // namespace algorithm
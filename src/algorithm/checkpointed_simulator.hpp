@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "algorithm/fault_simulator.hpp"
+#include "core/circuit.hpp"
+
+namespace algorithm {
+
+// Runs another engine over consecutive pattern chunks and records every finished chunk in a
+// binary checkpoint, so a killed run can resume from the last completed chunk.
+class CheckpointedSimulator : public FaultSimulator {
+public:
+    using Factory = std::function<std::unique_ptr<FaultSimulator>(
+        const core::Circuit&, const std::vector<io::PatternRow>&)>;
+
+    struct Options {
+        std::string path;
+        std::size_t chunk_patterns{1024};
+        bool resume{false};
+    };
+
+    CheckpointedSimulator(const core::Circuit& circuit, const std::vector<io::PatternRow>& rows,
+                          Factory factory, Options options);
+    ~CheckpointedSimulator() override = default;
+
+    void start() override;
+
+private:
+    Factory factory_;
+    Options options_;
+};
+
+}  // namespace algorithm
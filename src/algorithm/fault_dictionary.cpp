@@ -0,0 +1,119 @@
+#include "algorithm/fault_dictionary.hpp"
+
+#include <algorithm>
+#include <limits>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "algorithm/fault_propagation.hpp"
+#include "core/simulator.hpp"
+
+namespace algorithm {
+
+namespace {
+
+using Word = FanoutPropagator::Word;
+
+// splitmix64 finalizer.
+std::uint64_t mix(std::uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+// Summed rather than chained, so the order outputs are reached in does not matter. Only the
+// `lanes` part of each difference counts.
+std::uint64_t responseSignature(const std::vector<FanoutPropagator::OutputDiff>& diffs,
+                                Word lanes) {
+    std::uint64_t signature = 0;
+    bool failed = false;
+    for (const auto& diff : diffs) {
+        const Word failing = diff.lanes & lanes;
+        if (failing != 0) {
+            signature += mix(mix(diff.net + 0x9e3779b97f4a7c15ULL) ^ failing);
+            failed = true;
+        }
+    }
+    return signature != 0 || !failed ? signature : 1;
+}
+
+}  // namespace
+
+std::size_t FaultDictionary::detectedFaults() const {
+    std::size_t detected = 0;
+    for (std::size_t f = 0; f < fault_count; ++f) {
+        const auto begin = fail_words.begin() + static_cast<std::ptrdiff_t>(f * block_count);
+        detected += std::any_of(begin, begin + static_cast<std::ptrdiff_t>(block_count),
+                                [](std::uint64_t word) { return word != 0; });
+    }
+    return detected;
+}
+
+FaultDictionary buildFaultDictionary(const core::Circuit& circuit,
+                                     const std::vector<core::Pattern>& patterns) {
+    const core::Simulator good(circuit);
+    const FanoutPropagator propagator(circuit);
+    int thread_count = 1;
+#ifdef _OPENMP
+    thread_count = std::max(1, omp_get_max_threads());
+#endif
+    std::vector<FanoutPropagator::Workspace> workspaces;
+    std::vector<std::vector<FanoutPropagator::OutputDiff>> diffs(
+        static_cast<std::size_t>(thread_count));
+    for (int t = 0; t < thread_count; ++t) {
+        workspaces.push_back(propagator.makeWorkspace());
+    }
+
+    FaultDictionary dictionary;
+    dictionary.pattern_count = patterns.size();
+    dictionary.fault_count = circuit.netCount() * 2;
+    dictionary.block_count = (patterns.size() + 63) / 64;
+    dictionary.fail_words.assign(dictionary.fault_count * dictionary.block_count, 0);
+    dictionary.signatures.assign(dictionary.fault_count * dictionary.block_count, 0);
+
+    std::vector<Word> net_words;
+    std::vector<Word> po_words;
+    for (std::size_t b = 0; b < dictionary.block_count; ++b) {
+        const std::size_t first = b * 64;
+        const std::size_t count = std::min<std::size_t>(64, patterns.size() - first);
+        const Word lanes = count == 64 ? std::numeric_limits<Word>::max()
+                                       : ((Word{1} << count) - 1);
+        good.simulateWords(core::PackedPatterns::pack(circuit, patterns, first, count), po_words,
+                           &net_words);
+        for (auto& ws : workspaces) {
+            ws.values = net_words;
+        }
+
+        // SA0 is only excited where the good value is 1 and SA1 only where it is 0, so one
+        // propagation of the complemented good value serves both faults of a net.
+#pragma omp parallel for schedule(dynamic, 32)
+        for (long long n = 0; n < static_cast<long long>(circuit.netCount()); ++n) {
+#ifdef _OPENMP
+            const auto t = static_cast<std::size_t>(omp_get_thread_num());
+#else
+            const std::size_t t = 0;
+#endif
+            const auto net = static_cast<core::NetId>(n);
+            auto& reached = diffs[t];
+            reached.clear();
+            const Word failing = propagator.propagate(net, lanes, net_words, workspaces[t],
+                                                      &reached);
+            if (failing == 0) {
+                continue;
+            }
+            const Word excite[2] = {net_words[net] & lanes, ~net_words[net] & lanes};
+            for (std::size_t stuck = 0; stuck < 2; ++stuck) {
+                const std::size_t slot = (net * 2 + stuck) * dictionary.block_count + b;
+                dictionary.fail_words[slot] = failing & excite[stuck];
+                dictionary.signatures[slot] = responseSignature(reached, excite[stuck]);
+            }
+        }
+    }
+    return dictionary;
+}
+
+}  // namespace algorithm
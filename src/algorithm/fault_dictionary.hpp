@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "algorithm/fault_dropping.hpp"
+#include "core/circuit.hpp"
+#include "core/pattern_generator.hpp"
+
+namespace algorithm {
+
+// Diagnosis data for every stuck-at fault (FaultId numbering) and 64-pattern block, stored
+// fault-major at [fault * block_count + block]. A failure is a primary output that differs
+// from the good machine.
+struct FaultDictionary {
+    std::size_t pattern_count{0};
+    std::size_t fault_count{0};
+    std::size_t block_count{0};
+    // Pass/fail dictionary: bit p % 64 is set when pattern p fails on some output.
+    std::vector<std::uint64_t> fail_words;
+    // Full-response signature: an order-independent hash of every (output net, failing lanes)
+    // pair of the block, 0 exactly when the block has no failure.
+    std::vector<std::uint64_t> signatures;
+
+    std::size_t detectedFaults() const;
+};
+
+// One good-machine pass per block, then both faults of every net are propagated together,
+// without fault dropping, collecting the outputs they reach on the way.
+FaultDictionary buildFaultDictionary(const core::Circuit& circuit,
+                                     const std::vector<core::Pattern>& patterns);
+
+}  // namespace algorithm
@@ -0,0 +1,100 @@
+#include "algorithm/fault_dropping.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "algorithm/fault_propagation.hpp"
+#include "core/simulator.hpp"
+
+namespace algorithm {
+
+namespace {
+
+using Word = FanoutPropagator::Word;
+
+}  // namespace
+
+std::vector<FaultId> allStuckAtFaults(const core::Circuit& circuit) {
+    std::vector<FaultId> faults(circuit.netCount() * 2);
+    for (std::size_t f = 0; f < faults.size(); ++f) {
+        faults[f] = static_cast<FaultId>(f);
+    }
+    return faults;
+}
+
+DroppingResult simulateWithDropping(const core::Circuit& circuit,
+                                    const std::vector<core::Pattern>& patterns,
+                                    std::vector<FaultId> faults) {
+    const core::Simulator good(circuit);
+    const FanoutPropagator propagator(circuit);
+    int thread_count = 1;
+#ifdef _OPENMP
+    thread_count = std::max(1, omp_get_max_threads());
+#endif
+    std::vector<FanoutPropagator::Workspace> workspaces;
+    for (int t = 0; t < thread_count; ++t) {
+        workspaces.push_back(propagator.makeWorkspace());
+    }
+
+    std::vector<FaultId> active = std::move(faults);
+    std::vector<Word> detected_lanes(active.size());
+    std::vector<Word> net_words;
+    std::vector<Word> po_words;
+    DroppingResult pass;
+
+    const std::size_t block_count = (patterns.size() + 63) / 64;
+    for (std::size_t b = block_count; b-- > 0 && !active.empty();) {
+        const std::size_t first = b * 64;
+        const std::size_t count = std::min<std::size_t>(64, patterns.size() - first);
+        const Word lanes = count == 64 ? std::numeric_limits<Word>::max()
+                                       : ((Word{1} << count) - 1);
+        good.simulateWords(core::PackedPatterns::pack(circuit, patterns, first, count), po_words,
+                           &net_words);
+        for (auto& ws : workspaces) {
+            ws.values = net_words;
+        }
+
+#pragma omp parallel for schedule(dynamic, 64)
+        for (long long k = 0; k < static_cast<long long>(active.size()); ++k) {
+#ifdef _OPENMP
+            auto& ws = workspaces[static_cast<std::size_t>(omp_get_thread_num())];
+#else
+            auto& ws = workspaces.front();
+#endif
+            const FaultId fault = active[static_cast<std::size_t>(k)];
+            const core::NetId net = fault / 2;
+            // Only the lanes where the good value differs from the stuck value excite it.
+            const Word flip = (fault % 2 == 0 ? net_words[net] : ~net_words[net]) & lanes;
+            detected_lanes[static_cast<std::size_t>(k)] =
+                flip ? propagator.propagate(net, flip, net_words, ws) : 0;
+        }
+
+        Word essential = 0;
+        std::size_t still_active = 0;
+        for (std::size_t k = 0; k < active.size(); ++k) {
+            const Word hits = detected_lanes[k];
+            if (hits == 0) {
+                active[still_active++] = active[k];
+                continue;
+            }
+            essential |= Word{1} << (63 - std::countl_zero(hits));
+            pass.detected_faults.push_back(active[k]);
+        }
+        active.resize(still_active);
+        for (std::size_t lane = count; lane-- > 0;) {
+            if ((essential >> lane) & 1U) {
+                pass.last_detecting_rows.push_back(first + lane);
+            }
+        }
+    }
+    pass.detected = pass.detected_faults.size();
+    std::reverse(pass.last_detecting_rows.begin(), pass.last_detecting_rows.end());
+    return pass;
+}
+
+}  // namespace algorithm
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "core/circuit.hpp"
+#include "core/pattern_generator.hpp"
+
+namespace algorithm {
+
+// Fault f is stuck-at-(f % 2) on net f / 2, matching the SA0/SA1 columns of .ans.
+using FaultId = std::uint32_t;
+
+std::vector<FaultId> allStuckAtFaults(const core::Circuit& circuit);
+
+struct DroppingResult {
+    // Number of `faults` detected by at least one pattern.
+    std::size_t detected{0};
+    std::vector<FaultId> detected_faults;
+    // For every detected fault, the last pattern detecting it (ascending, no repeats).
+    std::vector<std::size_t> last_detecting_rows;
+};
+
+// Simulates `patterns` in 64-pattern blocks, last block first, against the faults not yet
+// detected: each block is good-machine simulated once and every remaining fault is
+// propagated only in the lanes that excite it. Detected faults are dropped.
+DroppingResult simulateWithDropping(const core::Circuit& circuit,
+                                    const std::vector<core::Pattern>& patterns,
+                                    std::vector<FaultId> faults);
+
+}  // namespace algorithm
@@ -0,0 +1,168 @@
+#include "algorithm/fault_propagation.hpp"
+
+#include <stdexcept>
+#include <utility>
+
+#include "core/observability.hpp"
+
+namespace algorithm {
+
+namespace {
+
+using Word = uint64_t;
+
+Word evaluateGateWord(const core::Gate& gate, const std::vector<Word>& values) {
+    const auto& inputs = gate.inputs;
+    if (inputs.empty()) {
+        throw std::runtime_error("Gate missing inputs during simulation");
+    }
+    Word result = values[inputs.front()];
+    switch (gate.type) {
+        case core::GateType::And:
+        case core::GateType::Nand:
+            for (std::size_t i = 1; i < inputs.size(); ++i) {
+                result &= values[inputs[i]];
+            }
+            break;
+        case core::GateType::Or:
+        case core::GateType::Nor:
+            for (std::size_t i = 1; i < inputs.size(); ++i) {
+                result |= values[inputs[i]];
+            }
+            break;
+        case core::GateType::Xor:
+        case core::GateType::Xnor:
+            for (std::size_t i = 1; i < inputs.size(); ++i) {
+                result ^= values[inputs[i]];
+            }
+            break;
+        case core::GateType::Not:
+        case core::GateType::Buf:
+            break;
+        case core::GateType::Unknown:
+        default:
+            throw std::runtime_error("Unknown gate type encountered during simulation");
+    }
+    if (gate.type == core::GateType::Nand || gate.type == core::GateType::Nor ||
+        gate.type == core::GateType::Xnor || gate.type == core::GateType::Not) {
+        result = ~result;
+    }
+    return result;
+}
+
+}  // namespace
+
+FanoutPropagator::FanoutPropagator(const core::Circuit& circuit) : circuit_(circuit) {
+    const auto& gates = circuit_.gates();
+    const std::size_t net_count = circuit_.netCount();
+    std::vector<int> driver(net_count, -1);
+    for (std::size_t i = 0; i < gates.size(); ++i) {
+        driver[gates[i].output] = static_cast<int>(i);
+    }
+    fanout_gates_.assign(net_count, {});
+    std::vector<std::size_t> pending(gates.size(), 0);
+    for (std::size_t i = 0; i < gates.size(); ++i) {
+        for (const core::NetId net : gates[i].inputs) {
+            fanout_gates_[net].push_back(i);
+            if (driver[net] >= 0) {
+                ++pending[i];
+            }
+        }
+    }
+    for (std::size_t i = 0; i < gates.size(); ++i) {
+        if (pending[i] == 0) {
+            topo_order_.push_back(i);
+        }
+    }
+    for (std::size_t head = 0; head < topo_order_.size(); ++head) {
+        for (const std::size_t next : fanout_gates_[gates[topo_order_[head]].output]) {
+            if (--pending[next] == 0) {
+                topo_order_.push_back(next);
+            }
+        }
+    }
+    if (topo_order_.size() != gates.size()) {
+        throw std::runtime_error("Fault propagation requires an acyclic circuit");
+    }
+    topo_position_.assign(gates.size(), 0);
+    for (std::size_t pos = 0; pos < topo_order_.size(); ++pos) {
+        topo_position_[topo_order_[pos]] = pos;
+    }
+
+    is_output_.assign(net_count, 0);
+    for (const core::NetId po : circuit_.primaryOutputs()) {
+        is_output_[po] = 1;
+    }
+
+    // Ordering needs every gate; scheduling only the observable ones.
+    auto observability = core::analyzeObservability(circuit_, 0);
+    for (auto& readers : fanout_gates_) {
+        std::erase_if(readers, [&](std::size_t gate_index) {
+            return !observability.gate_observable[gate_index];
+        });
+    }
+    observable_ = std::move(observability.observable);
+}
+
+FanoutPropagator::Workspace FanoutPropagator::makeWorkspace() const {
+    Workspace ws;
+    ws.values.assign(circuit_.netCount(), 0);
+    ws.queued.assign(circuit_.gates().size(), 0);
+    return ws;
+}
+
+FanoutPropagator::Word FanoutPropagator::propagate(core::NetId net, Word flip,
+                                                   const std::vector<Word>& good, Workspace& ws,
+                                                   std::vector<OutputDiff>* output_diffs) const {
+    if (!observable_[net]) {
+        return 0;
+    }
+    const auto& gates = circuit_.gates();
+    auto schedule = [&](core::NetId changed) {
+        for (const std::size_t gate_index : fanout_gates_[changed]) {
+            const std::size_t pos = topo_position_[gate_index];
+            if (!ws.queued[pos]) {
+                ws.queued[pos] = 1;
+                ws.pending.push(pos);
+            }
+        }
+    };
+
+    ws.values[net] = good[net] ^ flip;
+    ws.touched.push_back(net);
+    Word detected = 0;
+    if (is_output_[net]) {
+        detected = flip;
+        if (output_diffs) {
+            output_diffs->push_back({net, flip});
+        }
+    }
+    schedule(net);
+    while (!ws.pending.empty()) {
+        const std::size_t pos = ws.pending.top();
+        ws.pending.pop();
+        ws.queued[pos] = 0;
+        const auto& gate = gates[topo_order_[pos]];
+        const Word value = evaluateGateWord(gate, ws.values);
+        const Word diff = value ^ good[gate.output];
+        if (diff == 0) {
+            continue;
+        }
+        ws.values[gate.output] = value;
+        ws.touched.push_back(gate.output);
+        if (is_output_[gate.output]) {
+            detected |= diff;
+            if (output_diffs) {
+                output_diffs->push_back({gate.output, diff});
+            }
+        }
+        schedule(gate.output);
+    }
+    for (const core::NetId touched : ws.touched) {
+        ws.values[touched] = good[touched];
+    }
+    ws.touched.clear();
+    return detected & flip;
+}
+
+}  // namespace algorithm
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <vector>
+
+#include "core/circuit.hpp"
+
+namespace algorithm {
+
+// Event-driven propagation of a fault effect over 64-lane good-machine words (one word per
+// net, as produced by core::Simulator::simulateWords). Only gates whose inputs actually
+// change are re-evaluated, in dependency order, and gates that cannot reach a primary output
+// are never scheduled.
+class FanoutPropagator {
+public:
+    using Word = std::uint64_t;
+
+    // A primary output net and the lanes in which it differs from the good machine.
+    struct OutputDiff {
+        core::NetId net;
+        Word lanes;
+    };
+
+    // Per-thread scratch. `values` must equal the good-machine words on entry to propagate();
+    // every net it changes is restored before it returns.
+    struct Workspace {
+        std::vector<Word> values;
+        std::vector<std::uint8_t> queued;
+        std::vector<core::NetId> touched;
+        std::priority_queue<std::size_t, std::vector<std::size_t>, std::greater<>> pending;
+    };
+
+    explicit FanoutPropagator(const core::Circuit& circuit);
+
+    Workspace makeWorkspace() const;
+    // Flips the `flip` lanes of `net` and returns the lanes in which a primary output changes;
+    // always 0, without simulating, for a net outside every output cone. When `output_diffs`
+    // is given, every changed output is also appended to it.
+    Word propagate(core::NetId net, Word flip, const std::vector<Word>& good, Workspace& ws,
+                   std::vector<OutputDiff>* output_diffs = nullptr) const;
+
+private:
+    const core::Circuit& circuit_;
+    // Gates in dependency order, each gate's position in it, and the gates reading each net.
+    std::vector<std::size_t> topo_order_;
+    std::vector<std::size_t> topo_position_;
+    std::vector<std::vector<std::size_t>> fanout_gates_;
+    std::vector<std::uint8_t> is_output_;
+    std::vector<std::uint8_t> observable_;
+};
+
+}  // namespace algorithm
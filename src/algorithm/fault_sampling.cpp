@@ -0,0 +1,201 @@
+#include "algorithm/fault_sampling.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <utility>
+
+#include "algorithm/fault_dropping.hpp"
+
+namespace algorithm {
+
+namespace {
+
+constexpr std::size_t kDepthBuckets = 4;
+constexpr std::size_t kGateTypes = static_cast<std::size_t>(core::GateType::Unknown) + 1;
+// Two-sided 95% normal quantile.
+constexpr double kZ95 = 1.959963984540054;
+
+// Stratum of every net: depth quarter x driving gate type (Unknown for undriven nets).
+std::vector<std::size_t> netStrata(const core::Circuit& circuit) {
+    const auto& gates = circuit.gates();
+    const std::size_t net_count = circuit.netCount();
+    std::vector<int> driver(net_count, -1);
+    for (std::size_t i = 0; i < gates.size(); ++i) {
+        driver[gates[i].output] = static_cast<int>(i);
+    }
+
+    // Longest path from an undriven net, relaxed in dependency order.
+    std::vector<std::vector<std::size_t>> readers(net_count);
+    std::vector<std::size_t> pending(gates.size(), 0);
+    for (std::size_t i = 0; i < gates.size(); ++i) {
+        for (const core::NetId net : gates[i].inputs) {
+            readers[net].push_back(i);
+            if (driver[net] >= 0) {
+                ++pending[i];
+            }
+        }
+    }
+    std::vector<std::size_t> ready;
+    for (std::size_t i = 0; i < gates.size(); ++i) {
+        if (pending[i] == 0) {
+            ready.push_back(i);
+        }
+    }
+    std::vector<std::size_t> level(net_count, 0);
+    std::size_t max_level = 0;
+    for (std::size_t head = 0; head < ready.size(); ++head) {
+        const auto& gate = gates[ready[head]];
+        std::size_t depth = 0;
+        for (const core::NetId net : gate.inputs) {
+            depth = std::max(depth, level[net]);
+        }
+        level[gate.output] = depth + 1;
+        max_level = std::max(max_level, depth + 1);
+        for (const std::size_t next : readers[gate.output]) {
+            if (--pending[next] == 0) {
+                ready.push_back(next);
+            }
+        }
+    }
+
+    std::vector<std::size_t> stratum(net_count);
+    for (std::size_t net = 0; net < net_count; ++net) {
+        const core::GateType type =
+            driver[net] < 0 ? core::GateType::Unknown
+                            : gates[static_cast<std::size_t>(driver[net])].type;
+        const std::size_t bucket = level[net] * kDepthBuckets / (max_level + 1);
+        stratum[net] = bucket * kGateTypes + static_cast<std::size_t>(type);
+    }
+    return stratum;
+}
+
+// At least one fault per non-empty stratum (when the sample allows), the rest by largest
+// remainder of the proportional share.
+std::vector<std::size_t> allocate(const std::vector<std::size_t>& sizes, std::size_t sample) {
+    std::vector<std::size_t> take(sizes.size(), 0);
+    std::size_t population = 0;
+    std::size_t nonempty = 0;
+    for (const std::size_t size : sizes) {
+        population += size;
+        nonempty += size > 0 ? 1 : 0;
+    }
+    if (population == 0) {
+        return take;
+    }
+    std::size_t left = std::min(sample, population);
+    if (left >= nonempty) {
+        for (std::size_t h = 0; h < sizes.size(); ++h) {
+            take[h] = sizes[h] > 0 ? 1 : 0;
+        }
+        left -= nonempty;
+    }
+    std::vector<std::pair<double, std::size_t>> remainders;
+    const std::size_t base = left;
+    for (std::size_t h = 0; h < sizes.size(); ++h) {
+        const double share =
+            static_cast<double>(base) * static_cast<double>(sizes[h]) / population;
+        const std::size_t whole =
+            std::min(static_cast<std::size_t>(share), sizes[h] - take[h]);
+        take[h] += whole;
+        left -= whole;
+        if (take[h] < sizes[h]) {
+            remainders.emplace_back(share - std::floor(share), h);
+        }
+    }
+    std::stable_sort(remainders.begin(), remainders.end(),
+                     [](const auto& a, const auto& b) { return a.first > b.first; });
+    while (left > 0) {
+        bool placed = false;
+        for (const auto& entry : remainders) {
+            if (left > 0 && take[entry.second] < sizes[entry.second]) {
+                ++take[entry.second];
+                --left;
+                placed = true;
+            }
+        }
+        if (!placed) {
+            break;
+        }
+    }
+    return take;
+}
+
+}  // namespace
+
+CoverageEstimate estimateCoverage(const core::Circuit& circuit,
+                                  const std::vector<io::PatternRow>& rows,
+                                  std::size_t sample_size, std::uint64_t seed) {
+    const std::vector<std::size_t> net_stratum = netStrata(circuit);
+    std::vector<std::vector<FaultId>> strata(kDepthBuckets * kGateTypes);
+    for (const FaultId fault : allStuckAtFaults(circuit)) {
+        strata[net_stratum[fault / 2]].push_back(fault);
+    }
+    std::vector<std::size_t> sizes(strata.size());
+    for (std::size_t h = 0; h < strata.size(); ++h) {
+        sizes[h] = strata[h].size();
+    }
+    const std::vector<std::size_t> take = allocate(sizes, sample_size);
+
+    // Partial Fisher-Yates per stratum; the first take[h] faults are the sample.
+    std::mt19937_64 rng(seed);
+    std::vector<FaultId> sample;
+    std::vector<std::size_t> fault_stratum(circuit.netCount() * 2);
+    for (std::size_t h = 0; h < strata.size(); ++h) {
+        auto& faults = strata[h];
+        for (std::size_t i = 0; i < take[h]; ++i) {
+            std::uniform_int_distribution<std::size_t> pick(i, faults.size() - 1);
+            std::swap(faults[i], faults[pick(rng)]);
+            sample.push_back(faults[i]);
+            fault_stratum[faults[i]] = h;
+        }
+    }
+    std::sort(sample.begin(), sample.end());
+
+    std::vector<core::Pattern> patterns;
+    patterns.reserve(rows.size());
+    for (const auto& row : rows) {
+        patterns.push_back(row.pattern);
+    }
+    const DroppingResult result = simulateWithDropping(circuit, patterns, sample);
+    std::vector<std::size_t> hits(strata.size(), 0);
+    for (const FaultId fault : result.detected_faults) {
+        ++hits[fault_stratum[fault]];
+    }
+
+    CoverageEstimate estimate;
+    estimate.population = fault_stratum.size();
+    estimate.sample_size = sample.size();
+    estimate.detected_in_sample = result.detected;
+    double variance = 0.0;
+    double sampled_weight = 0.0;
+    for (std::size_t h = 0; h < strata.size(); ++h) {
+        if (take[h] == 0) {
+            continue;
+        }
+        ++estimate.strata;
+        const double weight = static_cast<double>(sizes[h]) / estimate.population;
+        const double n = static_cast<double>(take[h]);
+        const double p = static_cast<double>(hits[h]) / n;
+        estimate.coverage += weight * p;
+        sampled_weight += weight;
+        if (take[h] == sizes[h]) {
+            continue;
+        }
+        // A lone sample says nothing about its stratum's spread: assume the worst, p = 1/2.
+        const double spread = take[h] > 1 ? p * (1.0 - p) / (n - 1.0) : 0.25;
+        const double finite = 1.0 - n / static_cast<double>(sizes[h]);
+        variance += weight * weight * finite * spread;
+    }
+    // Samples smaller than the stratum count leave some strata out; rescale to the rest.
+    if (sampled_weight > 0.0) {
+        estimate.coverage /= sampled_weight;
+        variance /= sampled_weight * sampled_weight;
+    }
+    const double half_width = kZ95 * std::sqrt(variance);
+    estimate.lower = std::max(0.0, estimate.coverage - half_width);
+    estimate.upper = std::min(1.0, estimate.coverage + half_width);
+    return estimate;
+}
+
+}  // namespace algorithm
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "core/circuit.hpp"
+#include "io/pattern_loader.hpp"
+
+namespace algorithm {
+
+struct CoverageEstimate {
+    std::size_t population{0};
+    std::size_t sample_size{0};
+    std::size_t strata{0};
+    std::size_t detected_in_sample{0};
+    double coverage{0.0};
+    // Normal-approximation 95% interval, clipped to [0, 1].
+    double lower{0.0};
+    double upper{0.0};
+};
+
+// Estimates stuck-at coverage of `rows` from `sample_size` faults. Faults are stratified by
+// the driving gate type and by depth quarter (primary inputs and undriven nets form their own
+// type); every stratum gets at least one fault when the sample allows, the rest is allocated
+// proportionally. The estimate is the stratum-weighted detection rate. A sample of at least
+// the full population simulates every fault and gives an exact answer.
+CoverageEstimate estimateCoverage(const core::Circuit& circuit,
+                                  const std::vector<io::PatternRow>& rows,
+                                  std::size_t sample_size, std::uint64_t seed);
+
+}  // namespace algorithm
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
 #include <sstream>
 #include <stdexcept>
 #include <string>
@@ -62,6 +64,32 @@ struct AnswerTable {
         }
     }
 
+    // Marks a fault as potentially detected; call alongside set(), which records eq = true.
+    void setPotential(std::size_t pattern_index, std::size_t net_id, bool stuck_at_0) {
+        if (pattern_index >= table.size() || net_id >= net_count) {
+            throw std::runtime_error("Answer table index out of range");
+        }
+        auto& entry = table[pattern_index][net_id];
+        if (stuck_at_0) {
+            entry.stuck0_potential = true;
+        } else {
+            entry.stuck1_potential = true;
+        }
+    }
+
+    void setRow(std::size_t pattern_index, const std::vector<FaultEvaluation>& row) {
+        if (pattern_index >= table.size()) {
+            throw std::runtime_error("Pattern index out of range for answer table");
+        }
+        if (row.size() != net_count) {
+            throw std::runtime_error("Answer row size mismatch for answer table");
+        }
+        table[pattern_index] = row;
+        std::fill(filled_mask[pattern_index].begin(), filled_mask[pattern_index].end(),
+                  uint8_t{3});
+        filled_counts[pattern_index] = net_count * 2;
+    }
+
     void clear() {
         net_count = 0;
         table.clear();
@@ -81,8 +109,20 @@ public:
 
     const std::vector<std::string>& netNames() const { return net_names_; }
 
+    // Net ids in .ans order (by name), independent of how the circuit numbered them.
+    const std::vector<core::NetId>& answerNetOrder() const { return circuit_.netsByName(); }
+
     virtual void start() = 0;
 
+    // Engines that simulate X (core::kValueX) inputs in three-valued logic override this;
+    // the rest must not be given such rows.
+    virtual bool supportsUnknownValues() const { return false; }
+
+    // First line of the .ans; engines that grade other fault models name their columns here.
+    virtual const char* answerHeader() const {
+        return "# pattern_index net stuck_at_0_eq stuck_at_1_eq";
+    }
+
     std::size_t patternCount() const { return rows_.size(); }
 
     const core::Pattern& patternAt(std::size_t index) const {
@@ -5,6 +5,10 @@ namespace algorithm {
 struct FaultEvaluation {
     bool stuck0_eq{true};
     bool stuck1_eq{true};
+    // Only with X inputs: the fault never definitely changes an output but turns some known
+    // output into X. The matching *_eq stays true; .ans writes `X` for it.
+    bool stuck0_potential{false};
+    bool stuck1_potential{false};
 };
 
 }  // namespace algorithm
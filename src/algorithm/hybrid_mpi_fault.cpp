@@ -0,0 +1,168 @@
+#ifdef HYBRIDMPI
+
+#include "algorithm/hybrid_mpi_fault.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <limits>
+#include <stdexcept>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace algorithm {
+
+namespace {
+
+using Word = FanoutPropagator::Word;
+
+}  // namespace
+
+HybridMpiFaultSimulator::HybridMpiFaultSimulator(const core::Circuit& circuit,
+                                                 const std::vector<io::PatternRow>& rows,
+                                                 MPI_Comm comm)
+    : FaultSimulator(circuit, rows), comm_(comm), good_(circuit), propagator_(circuit) {
+    if (MPI_Comm_rank(comm_, &mpi_rank_) != MPI_SUCCESS ||
+        MPI_Comm_size(comm_, &mpi_size_) != MPI_SUCCESS) {
+        throw std::runtime_error("Unable to query MPI rank/size");
+    }
+    const std::size_t net_count = circuit_.netCount();
+    const std::size_t ranks = static_cast<std::size_t>(mpi_size_);
+    net_begin_.resize(ranks + 1);
+    for (std::size_t r = 0; r <= ranks; ++r) {
+        net_begin_[r] = net_count * r / ranks;
+    }
+}
+
+// Words of one chunk, as gathered: per net in id order, its stuck-at-0 then stuck-at-1 eq word.
+void HybridMpiFaultSimulator::unpackChunk(std::size_t chunk, const std::vector<Word>& words) {
+    const std::size_t first = chunk * 64;
+    const std::size_t count = std::min<std::size_t>(64, rows_.size() - first);
+    const std::size_t net_count = circuit_.netCount();
+    for (std::size_t net = 0; net < net_count; ++net) {
+        const Word eq0 = words[2 * net];
+        const Word eq1 = words[2 * net + 1];
+        for (std::size_t lane = 0; lane < count; ++lane) {
+            answers.set(first + lane, net, true, ((eq0 >> lane) & 1U) != 0);
+            answers.set(first + lane, net, false, ((eq1 >> lane) & 1U) != 0);
+        }
+    }
+}
+
+void HybridMpiFaultSimulator::start() {
+    const std::size_t pattern_count = rows_.size();
+    const std::size_t net_count = circuit_.netCount();
+    const std::size_t chunk_count = (pattern_count + 63) / 64;
+    const std::size_t own_begin = net_begin_[static_cast<std::size_t>(mpi_rank_)];
+    const std::size_t own_end = net_begin_[static_cast<std::size_t>(mpi_rank_) + 1];
+
+    std::vector<int> counts(static_cast<std::size_t>(mpi_size_));
+    std::vector<int> displacements(static_cast<std::size_t>(mpi_size_));
+    for (std::size_t r = 0; r < counts.size(); ++r) {
+        counts[r] = static_cast<int>(2 * (net_begin_[r + 1] - net_begin_[r]));
+        displacements[r] = static_cast<int>(2 * net_begin_[r]);
+    }
+
+    std::vector<core::Pattern> patterns(pattern_count);
+    for (std::size_t i = 0; i < pattern_count; ++i) {
+        patterns[i] = rows_[i].pattern;
+    }
+
+    int thread_count = 1;
+#ifdef _OPENMP
+    thread_count = std::max(1, omp_get_max_threads());
+#endif
+    std::vector<FanoutPropagator::Workspace> workspaces;
+    for (int t = 0; t < thread_count; ++t) {
+        workspaces.push_back(propagator_.makeWorkspace());
+    }
+
+    // Two buffers per side: chunk k's gather is in flight while chunk k + 1 fills the other
+    // one, and is only waited for when chunk k + 2 needs its buffer back.
+    std::vector<Word> send[2];
+    std::vector<Word> recv[2];
+    MPI_Request requests[2] = {MPI_REQUEST_NULL, MPI_REQUEST_NULL};
+    std::size_t in_flight[2] = {0, 0};
+    for (int s = 0; s < 2; ++s) {
+        send[s].resize(2 * (own_end - own_begin));
+        if (mpi_rank_ == 0) {
+            recv[s].resize(2 * net_count);
+        }
+    }
+    auto complete = [&](int slot) {
+        if (requests[slot] == MPI_REQUEST_NULL) {
+            return;
+        }
+        const double wait_start = MPI_Wtime();
+        MPI_Wait(&requests[slot], MPI_STATUS_IGNORE);
+        comm_wait_seconds_ += MPI_Wtime() - wait_start;
+        if (mpi_rank_ == 0) {
+            unpackChunk(in_flight[slot], recv[slot]);
+        }
+    };
+
+    std::vector<Word> good;
+    std::vector<Word> po_words;
+    std::exception_ptr failure;
+    for (std::size_t chunk = 0; chunk < chunk_count; ++chunk) {
+        const int slot = static_cast<int>(chunk % 2);
+        complete(slot);
+
+        const double compute_start = MPI_Wtime();
+        const std::size_t first = chunk * 64;
+        const std::size_t count = std::min<std::size_t>(64, pattern_count - first);
+        const Word lanes = count == 64 ? std::numeric_limits<Word>::max()
+                                       : ((Word{1} << count) - 1);
+        good_.simulateWords(core::PackedPatterns::pack(circuit_, patterns, first, count),
+                            po_words, &good);
+        std::vector<Word>& out = send[slot];
+
+#pragma omp parallel
+        {
+            int thread = 0;
+#ifdef _OPENMP
+            thread = omp_get_thread_num();
+#endif
+            auto& ws = workspaces[static_cast<std::size_t>(thread)];
+            ws.values = good;
+            // Flipping every lane of a net is SA0 where it is 1 and SA1 where it is 0.
+#pragma omp for schedule(dynamic, 64)
+            for (long long i = static_cast<long long>(own_begin);
+                 i < static_cast<long long>(own_end); ++i) {
+                const auto net = static_cast<core::NetId>(i);
+                try {
+                    const Word detected = propagator_.propagate(net, lanes, good, ws);
+                    const std::size_t at = 2 * (net - own_begin);
+                    out[at] = ~(detected & good[net]);
+                    out[at + 1] = ~(detected & ~good[net]);
+                } catch (...) {
+#pragma omp critical
+                    failure = std::current_exception();
+                }
+            }
+        }
+        compute_seconds_ += MPI_Wtime() - compute_start;
+        if (failure) {
+            // Let the other ranks fail with us instead of waiting on this rank's gathers.
+            MPI_Abort(comm_, 1);
+        }
+
+        in_flight[slot] = chunk;
+        MPI_Igatherv(out.data(), counts[static_cast<std::size_t>(mpi_rank_)], MPI_UINT64_T,
+                     mpi_rank_ == 0 ? recv[slot].data() : nullptr, counts.data(),
+                     displacements.data(), MPI_UINT64_T, 0, comm_, &requests[slot]);
+    }
+    complete(static_cast<int>(chunk_count % 2));
+    complete(static_cast<int>((chunk_count + 1) % 2));
+
+    double local[2] = {compute_seconds_, comm_wait_seconds_};
+    double slowest[2] = {0.0, 0.0};
+    MPI_Allreduce(local, slowest, 2, MPI_DOUBLE, MPI_MAX, comm_);
+    compute_seconds_ = slowest[0];
+    comm_wait_seconds_ = slowest[1];
+}
+
+}  // namespace algorithm
+
+#endif  // HYBRIDMPI
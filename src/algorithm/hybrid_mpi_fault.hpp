@@ -0,0 +1,52 @@
+#pragma once
+
+#ifdef HYBRIDMPI
+
+#include <cstddef>
+#include <vector>
+
+#include <mpi.h>
+
+#include "algorithm/fault_propagation.hpp"
+#include "algorithm/fault_simulator.hpp"
+#include "core/circuit.hpp"
+#include "core/simulator.hpp"
+
+namespace algorithm {
+
+// One rank per socket, an OpenMP team per rank. Nets are split into contiguous ranges, one
+// per rank; every rank simulates all patterns 64 at a time and grades only its own nets.
+// The eq words of chunk k are gathered to rank 0 with MPI_Igatherv while chunk k + 1 is
+// computed, so rank 0 is the only rank whose `answers` get filled.
+class HybridMpiFaultSimulator : public FaultSimulator {
+public:
+    HybridMpiFaultSimulator(const core::Circuit& circuit,
+                            const std::vector<io::PatternRow>& rows,
+                            MPI_Comm comm = MPI_COMM_WORLD);
+    ~HybridMpiFaultSimulator() override = default;
+
+    void start() override;
+
+    int rank() const { return mpi_rank_; }
+    int size() const { return mpi_size_; }
+    // Slowest rank's time in fault grading and blocked in MPI_Wait; valid after start().
+    double computeSeconds() const { return compute_seconds_; }
+    double commWaitSeconds() const { return comm_wait_seconds_; }
+
+private:
+    void unpackChunk(std::size_t chunk, const std::vector<FanoutPropagator::Word>& words);
+
+    MPI_Comm comm_;
+    int mpi_rank_{0};
+    int mpi_size_{1};
+    core::Simulator good_;
+    FanoutPropagator propagator_;
+    // Nets [net_begin_[r], net_begin_[r + 1]) are graded by rank r.
+    std::vector<std::size_t> net_begin_;
+    double compute_seconds_{0.0};
+    double comm_wait_seconds_{0.0};
+};
+
+}  // namespace algorithm
+
+#endif  // HYBRIDMPI
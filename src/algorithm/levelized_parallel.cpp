@@ -10,8 +10,8 @@
 namespace algorithm {
 
 LevelizedParallel::LevelizedParallel(
-    const core::Circuit& circuit, const std::vector<io::PatternRow>& rows)
-    : FaultSimulator(circuit, rows), circuit_(circuit) {
+    const core::Circuit& circuit, const std::vector<io::PatternRow>& rows, int num_threads)
+    : FaultSimulator(circuit, rows), circuit_(circuit), num_threads_(num_threads) {
     net_count_ = circuit_.netCount();
     primary_inputs_ = circuit_.primaryInputs();
     primary_outputs_ = circuit_.primaryOutputs();
@@ -230,7 +230,7 @@ bool LevelizedParallel::simulateFault(
     for (int lv=1; lv<=max_level_; ++lv) {
         const auto& level_gates = gates_by_level_[lv];
 
-        #pragma omp parallel for schedule(static) num_threads(2)
+        #pragma omp parallel for schedule(static) num_threads(num_threads_)
         for (std::size_t i = 0; i < level_gates.size(); ++i) {
             auto gate_idx = level_gates[i];
             const auto& gate = gates[gate_idx];
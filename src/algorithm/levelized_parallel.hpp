@@ -12,7 +12,8 @@ namespace algorithm {
 class LevelizedParallel : public FaultSimulator {
 public:
     LevelizedParallel(const core::Circuit& circuit,
-                               const std::vector<io::PatternRow>& rows);
+                               const std::vector<io::PatternRow>& rows,
+                               int num_threads = 2);
     ~LevelizedParallel() override = default;
 
     void start() override;
@@ -34,6 +35,7 @@ private:
     std::vector<core::NetId> primary_outputs_;
     std::vector<std::vector<std::size_t>> gates_by_level_;
     int max_level_ = 0;
+    int num_threads_ = 2;
 };
 
 }  // namespace algorithm
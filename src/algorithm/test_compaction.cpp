@@ -0,0 +1,31 @@
+#include "algorithm/test_compaction.hpp"
+
+#include "algorithm/fault_dropping.hpp"
+
+namespace algorithm {
+
+CompactionResult compactReverseOrder(const core::Circuit& circuit,
+                                     const std::vector<io::PatternRow>& rows) {
+    std::vector<core::Pattern> patterns;
+    patterns.reserve(rows.size());
+    for (const auto& row : rows) {
+        patterns.push_back(row.pattern);
+    }
+
+    CompactionResult result;
+    const auto faults = allStuckAtFaults(circuit);
+    result.fault_count = faults.size();
+    DroppingResult full = simulateWithDropping(circuit, patterns, faults);
+    result.detected_before = full.detected;
+    result.kept_rows = std::move(full.last_detecting_rows);
+
+    std::vector<core::Pattern> kept;
+    kept.reserve(result.kept_rows.size());
+    for (const std::size_t row : result.kept_rows) {
+        kept.push_back(patterns[row]);
+    }
+    result.detected_after = simulateWithDropping(circuit, kept, faults).detected;
+    return result;
+}
+
+}  // namespace algorithm
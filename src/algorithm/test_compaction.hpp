@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "core/circuit.hpp"
+#include "io/pattern_loader.hpp"
+
+namespace algorithm {
+
+struct CompactionResult {
+    // Stuck-at faults considered: SA0 and SA1 on every net, as in the .ans files.
+    std::size_t fault_count{0};
+    std::size_t detected_before{0};
+    // Re-simulated on the kept rows alone.
+    std::size_t detected_after{0};
+    // Indices into the input rows, ascending.
+    std::vector<std::size_t> kept_rows;
+};
+
+// Reverse-order compaction: rows are fault simulated from last to first with fault dropping,
+// and a row is kept only if it detects a fault no later row detects. Within each 64-row
+// block that row is the highest set lane of the fault's detection word, so the result is
+// the same as dropping one row at a time.
+CompactionResult compactReverseOrder(const core::Circuit& circuit,
+                                     const std::vector<io::PatternRow>& rows);
+
+}  // namespace algorithm
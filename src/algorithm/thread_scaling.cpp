@@ -0,0 +1,308 @@
+#include "algorithm/thread_scaling.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <dirent.h>
+#include <functional>
+#include <linux/perf_event.h>
+#include <numeric>
+#include <stdexcept>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "algorithm/batch1_mt_fault.hpp"
+#include "algorithm/batch64_levelized_parallel.hpp"
+#include "algorithm/batch64_mt_fault.hpp"
+#include "algorithm/bit_parallel_simulator.hpp"
+#include "algorithm/levelized_parallel.hpp"
+
+namespace algorithm {
+
+namespace {
+
+constexpr double kCacheLineBytes = 64.0;
+// Doubles per triad array: 32 MiB each, well past any last-level cache.
+constexpr std::size_t kStreamElements = std::size_t{1} << 22;
+constexpr int kStreamPasses = 5;
+
+double now() {
+    using Clock = std::chrono::steady_clock;
+    return std::chrono::duration<double>(Clock::now().time_since_epoch()).count();
+}
+
+std::vector<pid_t> threadIds() {
+    std::vector<pid_t> tids;
+    DIR* dir = opendir("/proc/self/task");
+    if (!dir) {
+        return tids;
+    }
+    while (const dirent* entry = readdir(dir)) {
+        if (entry->d_name[0] != '.') {
+            tids.push_back(static_cast<pid_t>(std::stol(entry->d_name)));
+        }
+    }
+    closedir(dir);
+    std::sort(tids.begin(), tids.end());
+    return tids;
+}
+
+// CPU time of any thread of this process. The clock id encoding is the one
+// pthread_getcpuclockid() uses (per-thread, scheduler clock); OpenMP hides the pthread_t.
+double threadCpuSeconds(pid_t tid) {
+    const clockid_t clock = static_cast<clockid_t>((~static_cast<unsigned>(tid)) << 3) | 6;
+    timespec ts{};
+    if (clock_gettime(clock, &ts) != 0) {
+        return 0.0;
+    }
+    return static_cast<double>(ts.tv_sec) + static_cast<double>(ts.tv_nsec) * 1e-9;
+}
+
+// Per-thread last-level cache miss counters. Threads must exist before open(), so the
+// OpenMP pool is warmed up first.
+class MissCounters {
+public:
+    ~MissCounters() { close(); }
+
+    bool open(const std::vector<pid_t>& tids) {
+        close();
+        for (const pid_t tid : tids) {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_CACHE_MISSES;
+            attr.disabled = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            const long fd = syscall(SYS_perf_event_open, &attr, tid, -1, -1, 0);
+            if (fd < 0) {
+                close();
+                return false;
+            }
+            fds_.push_back(static_cast<int>(fd));
+        }
+        for (const int fd : fds_) {
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+        return !fds_.empty();
+    }
+
+    double readBytes() {
+        std::uint64_t total = 0;
+        for (const int fd : fds_) {
+            ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+            std::uint64_t count = 0;
+            if (::read(fd, &count, sizeof(count)) == static_cast<ssize_t>(sizeof(count))) {
+                total += count;
+            }
+        }
+        return static_cast<double>(total) * kCacheLineBytes;
+    }
+
+private:
+    void close() {
+        for (const int fd : fds_) {
+            ::close(fd);
+        }
+        fds_.clear();
+    }
+
+    std::vector<int> fds_;
+};
+
+void warmUp(int threads) {
+#ifdef _OPENMP
+    omp_set_num_threads(threads);
+#pragma omp parallel num_threads(threads)
+    {
+        volatile int sink = omp_get_thread_num();
+        (void)sink;
+    }
+#else
+    (void)threads;
+#endif
+}
+
+// Best of kStreamPasses a[i] = b[i] + s * c[i] passes, counted as STREAM does (24 B/element).
+double streamTriadGbps(int threads) {
+    std::vector<double> a(kStreamElements);
+    std::vector<double> b(kStreamElements);
+    std::vector<double> c(kStreamElements);
+    const auto n = static_cast<long long>(kStreamElements);
+    // First touch from the same threads that run the triad.
+#pragma omp parallel for schedule(static) num_threads(threads)
+    for (long long i = 0; i < n; ++i) {
+        a[static_cast<std::size_t>(i)] = 0.0;
+        b[static_cast<std::size_t>(i)] = 1.0;
+        c[static_cast<std::size_t>(i)] = 2.0;
+    }
+    double best = 0.0;
+    for (int pass = 0; pass < kStreamPasses; ++pass) {
+        const double begin = now();
+#pragma omp parallel for schedule(static) num_threads(threads)
+        for (long long i = 0; i < n; ++i) {
+            const auto k = static_cast<std::size_t>(i);
+            a[k] = b[k] + 3.0 * c[k];
+        }
+        const double seconds = now() - begin;
+        if (seconds > 0.0) {
+            best = std::max(best, 24.0 * static_cast<double>(kStreamElements) / seconds / 1e9);
+        }
+    }
+    return best;
+}
+
+// Host bandwidth does not depend on the circuit; measured once per thread count.
+double cachedStreamGbps(int threads) {
+    static std::vector<double> cache;
+    if (cache.size() <= static_cast<std::size_t>(threads)) {
+        cache.resize(static_cast<std::size_t>(threads) + 1, -1.0);
+    }
+    double& gbps = cache[static_cast<std::size_t>(threads)];
+    if (gbps < 0.0) {
+        gbps = streamTriadGbps(threads);
+    }
+    return gbps;
+}
+
+struct RunMetrics {
+    double seconds{0.0};
+    double cpu_seconds{0.0};
+    double load_imbalance{1.0};
+    double miss_bytes{-1.0};
+    bool answers_ok{true};
+};
+
+RunMetrics runOnce(const std::string& engine, const core::Circuit& circuit,
+                   const std::vector<io::PatternRow>& rows, int threads,
+                   const ScalingOptions& options) {
+    auto simulator = makeScalableEngine(engine, circuit, rows, threads);
+    warmUp(threads);
+
+    const std::vector<pid_t> tids = threadIds();
+    std::vector<double> cpu_before(tids.size());
+    for (std::size_t i = 0; i < tids.size(); ++i) {
+        cpu_before[i] = threadCpuSeconds(tids[i]);
+    }
+    MissCounters counters;
+    const bool counting = counters.open(tids);
+
+    const double begin = now();
+    simulator->start();
+    RunMetrics run;
+    run.seconds = now() - begin;
+
+    if (counting) {
+        run.miss_bytes = counters.readBytes();
+    }
+    std::vector<double> busy(tids.size());
+    for (std::size_t i = 0; i < tids.size(); ++i) {
+        busy[i] = std::max(0.0, threadCpuSeconds(tids[i]) - cpu_before[i]);
+    }
+    run.cpu_seconds = std::accumulate(busy.begin(), busy.end(), 0.0);
+    std::sort(busy.begin(), busy.end(), std::greater<>());
+    busy.resize(std::min(busy.size(), static_cast<std::size_t>(threads)));
+    const double mean = busy.empty() ? 0.0
+                                     : std::accumulate(busy.begin(), busy.end(), 0.0) /
+                                           static_cast<double>(busy.size());
+    if (mean > 0.0) {
+        run.load_imbalance = busy.front() / mean;
+    }
+    if (options.check) {
+        run.answers_ok = options.check(*simulator);
+    }
+    return run;
+}
+
+}  // namespace
+
+const std::vector<std::string>& scalableEngineNames() {
+    static const std::vector<std::string> names = {
+        "batch64_mt", "batch1_mt", "bit_parallel", "batch64_levelized_parallel",
+        "levelized_parallel"};
+    return names;
+}
+
+std::unique_ptr<FaultSimulator> makeScalableEngine(const std::string& name,
+                                                   const core::Circuit& circuit,
+                                                   const std::vector<io::PatternRow>& rows,
+                                                   int threads) {
+    if (name == "batch64_mt") {
+        return std::make_unique<Batch64MtFaultSimulator>(circuit, rows, threads);
+    }
+    if (name == "batch1_mt") {
+        return std::make_unique<Batch1MtFaultSimulator>(circuit, rows, threads);
+    }
+    if (name == "bit_parallel") {
+        return std::make_unique<BitParallelSimulator>(circuit, rows, threads);
+    }
+    if (name == "batch64_levelized_parallel") {
+        return std::make_unique<Batch64LevelizedParallel>(circuit, rows, threads);
+    }
+    if (name == "levelized_parallel") {
+        return std::make_unique<LevelizedParallel>(circuit, rows, threads);
+    }
+    throw std::runtime_error("Unknown scalable engine: " + name);
+}
+
+std::vector<ScalingSample> measureThreadScaling(const core::Circuit& circuit,
+                                                const std::vector<io::PatternRow>& rows,
+                                                const ScalingOptions& options) {
+    int max_threads = options.max_threads;
+    if (max_threads <= 0) {
+#ifdef _OPENMP
+        max_threads = omp_get_num_procs();
+#else
+        max_threads = 1;
+#endif
+    }
+    const int repeats = std::max(1, options.repeats);
+    const auto& engines = options.engines.empty() ? scalableEngineNames() : options.engines;
+
+    std::vector<ScalingSample> samples;
+    for (const auto& engine : engines) {
+        double serial_seconds = 0.0;
+        for (int threads = 1; threads <= max_threads; ++threads) {
+            std::vector<RunMetrics> runs;
+            for (int r = 0; r < repeats; ++r) {
+                runs.push_back(runOnce(engine, circuit, rows, threads, options));
+            }
+            std::sort(runs.begin(), runs.end(), [](const RunMetrics& a, const RunMetrics& b) {
+                return a.seconds < b.seconds;
+            });
+            const RunMetrics& median = runs[runs.size() / 2];
+
+            ScalingSample sample;
+            sample.engine = engine;
+            sample.threads = threads;
+            sample.seconds = median.seconds;
+            if (threads == 1) {
+                serial_seconds = median.seconds;
+            }
+            sample.speedup = median.seconds > 0.0 ? serial_seconds / median.seconds : 0.0;
+            sample.efficiency = sample.speedup / threads;
+            sample.cpu_seconds = median.cpu_seconds;
+            sample.load_imbalance = median.load_imbalance;
+            sample.miss_bytes = median.miss_bytes;
+            if (median.miss_bytes >= 0.0 && median.seconds > 0.0) {
+                sample.memory_gbps = median.miss_bytes / median.seconds / 1e9;
+            }
+            sample.stream_gbps = cachedStreamGbps(threads);
+            sample.answers_ok = std::all_of(runs.begin(), runs.end(),
+                                            [](const RunMetrics& run) { return run.answers_ok; });
+            samples.push_back(std::move(sample));
+        }
+    }
+    return samples;
+}
+
+}  // namespace algorithm
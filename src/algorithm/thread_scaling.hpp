@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "algorithm/fault_simulator.hpp"
+#include "core/circuit.hpp"
+#include "io/pattern_loader.hpp"
+
+namespace algorithm {
+
+// The OpenMP engines whose thread count can be set: batch64_mt, batch1_mt, bit_parallel,
+// batch64_levelized_parallel and levelized_parallel.
+const std::vector<std::string>& scalableEngineNames();
+
+std::unique_ptr<FaultSimulator> makeScalableEngine(const std::string& name,
+                                                   const core::Circuit& circuit,
+                                                   const std::vector<io::PatternRow>& rows,
+                                                   int threads);
+
+struct ScalingOptions {
+    int max_threads{0};  // <= 0: omp_get_num_procs()
+    int repeats{3};
+    std::vector<std::string> engines;  // empty: every scalable engine
+    // Called after each run to check the answers; left out of the timing.
+    std::function<bool(const FaultSimulator&)> check;
+};
+
+// One engine at one thread count; timings are those of the median-time repeat.
+struct ScalingSample {
+    std::string engine;
+    int threads{0};
+    double seconds{0.0};
+    double speedup{0.0};     // seconds at 1 thread / seconds
+    double efficiency{0.0};  // speedup / threads
+    double cpu_seconds{0.0};
+    // Busiest thread's CPU time over the mean of the `threads` busiest threads; 1 is
+    // perfectly balanced. Spin-waiting at barriers counts as busy unless the run uses
+    // OMP_WAIT_POLICY=passive.
+    double load_imbalance{0.0};
+    // Last-level cache misses x 64 bytes, summed over threads; negative when the hardware
+    // counters are unavailable (no PMU, perf_event_paranoid, ...).
+    double miss_bytes{-1.0};
+    double memory_gbps{-1.0};
+    // Sustained triad bandwidth of this host at the same thread count, for scale.
+    double stream_gbps{0.0};
+    bool answers_ok{true};
+};
+
+// Sweeps 1..max_threads for every selected engine on one circuit.
+std::vector<ScalingSample> measureThreadScaling(const core::Circuit& circuit,
+                                                const std::vector<io::PatternRow>& rows,
+                                                const ScalingOptions& options);
+
+}  // namespace algorithm
@@ -0,0 +1,83 @@
+#include "algorithm/transition_fault.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+
+namespace algorithm {
+
+namespace {
+
+using Word = FanoutPropagator::Word;
+
+}  // namespace
+
+TransitionFaultSimulator::TransitionFaultSimulator(const core::Circuit& circuit,
+                                                   const std::vector<io::PatternRow>& launch_rows,
+                                                   const std::vector<io::PatternRow>& capture_rows)
+    : FaultSimulator(circuit, capture_rows),
+      launch_rows_(launch_rows),
+      good_(circuit),
+      propagator_(circuit) {
+    if (launch_rows_.size() != rows_.size()) {
+        throw std::runtime_error("Transition simulation needs one launch row per capture row");
+    }
+}
+
+void TransitionFaultSimulator::start() {
+    const std::size_t pair_count = rows_.size();
+    const std::size_t net_count = circuit_.netCount();
+
+    std::vector<core::Pattern> launch(pair_count);
+    std::vector<core::Pattern> capture(pair_count);
+    for (std::size_t i = 0; i < pair_count; ++i) {
+        launch[i] = launch_rows_[i].pattern;
+        capture[i] = rows_[i].pattern;
+    }
+    const std::size_t block_count = (pair_count + 63) / 64;
+    std::vector<core::PackedPatterns> packed_launch(block_count);
+    std::vector<core::PackedPatterns> packed_capture(block_count);
+    for (std::size_t b = 0; b < block_count; ++b) {
+        const std::size_t first = b * 64;
+        const std::size_t count = std::min<std::size_t>(64, pair_count - first);
+        packed_launch[b] = core::PackedPatterns::pack(circuit_, launch, first, count);
+        packed_capture[b] = core::PackedPatterns::pack(circuit_, capture, first, count);
+    }
+
+#pragma omp parallel
+    {
+        std::vector<Word> launch_values;
+        std::vector<Word> capture_values;
+        std::vector<Word> po_words;
+        auto ws = propagator_.makeWorkspace();
+
+#pragma omp for schedule(dynamic)
+        for (long long b = 0; b < static_cast<long long>(block_count); ++b) {
+            const auto& launch_block = packed_launch[static_cast<std::size_t>(b)];
+            const auto& capture_block = packed_capture[static_cast<std::size_t>(b)];
+            good_.simulateWords(launch_block, po_words, &launch_values);
+            good_.simulateWords(capture_block, po_words, &capture_values);
+            ws.values = capture_values;
+
+            const std::size_t first = static_cast<std::size_t>(b) * 64;
+            const std::size_t count = capture_block.pattern_count;
+            const Word lanes = count == 64 ? std::numeric_limits<Word>::max()
+                                           : ((Word{1} << count) - 1);
+            for (std::size_t net = 0; net < net_count; ++net) {
+                const Word rise = ~launch_values[net] & capture_values[net] & lanes;
+                const Word fall = launch_values[net] & ~capture_values[net] & lanes;
+                const Word rise_detected =
+                    rise ? propagator_.propagate(net, rise, capture_values, ws) : 0;
+                const Word fall_detected =
+                    fall ? propagator_.propagate(net, fall, capture_values, ws) : 0;
+                for (std::size_t lane = 0; lane < count; ++lane) {
+                    answers.set(first + lane, net, true, ((rise_detected >> lane) & 1U) == 0);
+                    answers.set(first + lane, net, false, ((fall_detected >> lane) & 1U) == 0);
+                }
+            }
+        }
+    }
+}
+
+}  // namespace algorithm
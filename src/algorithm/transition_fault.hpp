@@ -0,0 +1,37 @@
+#pragma once
+
+#include <vector>
+
+#include "algorithm/fault_propagation.hpp"
+#include "algorithm/fault_simulator.hpp"
+#include "core/circuit.hpp"
+#include "core/simulator.hpp"
+
+namespace algorithm {
+
+// Transition-delay grading of two-pattern tests. Row i of `capture_rows` is launched from
+// row i of `launch_rows`; answers use the stuck-at-0 slot for slow-to-rise and the stuck-at-1
+// slot for slow-to-fall (see answerHeader()).
+//
+// Both vectors of 64 pairs are good-machine simulated as one word per net. A slow-to-rise
+// fault on net n is activated in the lanes where n goes 0 -> 1, and is then propagated like
+// stuck-at-0 on the capture vector, restricted to those lanes (slow-to-fall likewise).
+class TransitionFaultSimulator : public FaultSimulator {
+public:
+    TransitionFaultSimulator(const core::Circuit& circuit,
+                             const std::vector<io::PatternRow>& launch_rows,
+                             const std::vector<io::PatternRow>& capture_rows);
+    ~TransitionFaultSimulator() override = default;
+
+    void start() override;
+    const char* answerHeader() const override {
+        return "# pattern_index net slow_to_rise_eq slow_to_fall_eq";
+    }
+
+private:
+    const std::vector<io::PatternRow>& launch_rows_;
+    core::Simulator good_;
+    FanoutPropagator propagator_;
+};
+
+}  // namespace algorithm
@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include <cctype>
+#include <cstdint>
 #include <limits>
 #include <numeric>
 #include <stdexcept>
@@ -122,13 +123,47 @@ void Circuit::addGate(const Gate& gate) {
     gates_.push_back(gate);
 }
 
-void Circuit::finalizeNets() {
+void Circuit::assignNets(std::vector<std::string> net_names, std::vector<NetType> net_types,
+                         std::vector<NetId> primary_inputs, std::vector<NetId> primary_outputs,
+                         std::vector<NetId> wires, std::vector<Gate> gates) {
+    const std::size_t count = net_names.size();
+    if (net_types.size() != count) {
+        throw std::invalid_argument("Net type table does not match net names");
+    }
+    auto in_range = [count](NetId id) { return id < count; };
+    if (!std::all_of(primary_inputs.begin(), primary_inputs.end(), in_range) ||
+        !std::all_of(primary_outputs.begin(), primary_outputs.end(), in_range) ||
+        !std::all_of(wires.begin(), wires.end(), in_range)) {
+        throw std::invalid_argument("Port list references unregistered net");
+    }
+    for (const auto& gate : gates) {
+        if (!in_range(gate.output)) {
+            throw std::invalid_argument("Gate references unregistered output net");
+        }
+        if (!std::all_of(gate.inputs.begin(), gate.inputs.end(), in_range)) {
+            throw std::invalid_argument("Gate references unregistered input net");
+        }
+    }
+    net_names_ = std::move(net_names);
+    net_types_ = std::move(net_types);
+    primary_inputs_ = std::move(primary_inputs);
+    primary_outputs_ = std::move(primary_outputs);
+    wires_ = std::move(wires);
+    gates_ = std::move(gates);
+    net_lookup_.clear();
+    nets_by_name_.clear();
+}
+
+void Circuit::finalizeNets(NetOrdering ordering) {
     const std::size_t count = net_names_.size();
-    std::vector<NetId> order(count);
-    std::iota(order.begin(), order.end(), 0);
-    std::sort(order.begin(), order.end(),
+    std::vector<NetId> name_order(count);
+    std::iota(name_order.begin(), name_order.end(), 0);
+    std::sort(name_order.begin(), name_order.end(),
               [&](NetId a, NetId b) { return net_names_[a] < net_names_[b]; });
 
+    const std::vector<NetId> order =
+        ordering == NetOrdering::Locality ? localityOrder(name_order) : name_order;
+
     std::vector<NetId> old_to_new(count);
     for (NetId new_id = 0; new_id < count; ++new_id) {
         old_to_new[order[new_id]] = new_id;
@@ -136,17 +171,23 @@ void Circuit::finalizeNets() {
 
     auto remap = [&](NetId id) { return old_to_new[id]; };
 
+    nets_by_name_.resize(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        nets_by_name_[i] = remap(name_order[i]);
+    }
+
     std::vector<std::string> new_names(count);
     std::vector<NetType> new_types(count);
     for (NetId new_id = 0; new_id < count; ++new_id) {
         const NetId old_id = order[new_id];
-        new_names[new_id] = net_names_[old_id];
+        new_names[new_id] = std::move(net_names_[old_id]);
         new_types[new_id] = net_types_[old_id];
     }
     net_names_ = std::move(new_names);
     net_types_ = std::move(new_types);
 
     net_lookup_.clear();
+    net_lookup_.reserve(count);
     for (NetId id = 0; id < net_names_.size(); ++id) {
         net_lookup_.emplace(net_names_[id], id);
     }
@@ -166,6 +207,71 @@ void Circuit::finalizeNets() {
             input = remap(input);
         }
     }
+
+    if (ordering == NetOrdering::Locality) {
+        // Post-order ids are topological, so sorting by output keeps gates evaluable in order.
+        std::stable_sort(gates_.begin(), gates_.end(),
+                         [](const Gate& a, const Gate& b) { return a.output < b.output; });
+    }
+}
+
+std::vector<NetId> Circuit::localityOrder(const std::vector<NetId>& name_order) const {
+    const std::size_t count = net_names_.size();
+    const std::size_t no_driver = std::numeric_limits<std::size_t>::max();
+    std::vector<std::size_t> driver(count, no_driver);
+    for (std::size_t i = 0; i < gates_.size(); ++i) {
+        driver[gates_[i].output] = i;
+    }
+
+    struct Frame {
+        NetId net;
+        std::size_t next_input;
+    };
+    enum : uint8_t { Unvisited, OnStack, Placed };
+
+    std::vector<NetId> order;
+    order.reserve(count);
+    std::vector<uint8_t> state(count, Unvisited);
+    std::vector<Frame> stack;
+
+    // Each net is placed right after the cone that computes it, so a gate output sits
+    // next to the inputs it was evaluated from and ahead of its first consumer.
+    auto visit = [&](NetId root) {
+        if (state[root] != Unvisited) {
+            return;
+        }
+        state[root] = OnStack;
+        stack.push_back({root, 0});
+        while (!stack.empty()) {
+            Frame& frame = stack.back();
+            const std::size_t gate_index = driver[frame.net];
+            if (gate_index != no_driver && frame.next_input < gates_[gate_index].inputs.size()) {
+                const NetId input = gates_[gate_index].inputs[frame.next_input++];
+                if (state[input] == OnStack) {
+                    throw std::runtime_error("Combinational loop detected while ordering nets");
+                }
+                if (state[input] == Unvisited) {
+                    state[input] = OnStack;
+                    stack.push_back({input, 0});
+                }
+                continue;
+            }
+            state[frame.net] = Placed;
+            order.push_back(frame.net);
+            stack.pop_back();
+        }
+    };
+
+    for (NetId po : primary_outputs_) {
+        visit(po);
+    }
+    for (const auto& gate : gates_) {
+        visit(gate.output);
+    }
+    for (NetId net : name_order) {
+        visit(net);
+    }
+    return order;
 }
 
 const std::vector<NetId>& Circuit::primaryInputs() const {
@@ -192,6 +298,10 @@ std::size_t Circuit::netCount() const {
     return net_names_.size();
 }
 
+const std::vector<NetId>& Circuit::netsByName() const {
+    return nets_by_name_;
+}
+
 const std::string& Circuit::netName(NetId id) const {
     if (id >= net_names_.size()) {
         throw std::out_of_range("Net id out of range");
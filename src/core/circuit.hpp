@@ -21,6 +21,14 @@ enum class GateType {
     Unknown,
 };
 
+// How finalizeNets() assigns net ids. ByName sorts by net name; Locality renumbers nets
+// in DFS post-order from the primary outputs so value arrays are walked nearly
+// sequentially during evaluation, and reorders gates to match.
+enum class NetOrdering {
+    ByName,
+    Locality,
+};
+
 enum class NetType {
     Unknown,
     PrimaryInput,
@@ -49,7 +57,13 @@ public:
 
     void addGate(const Gate& gate);
 
-    void finalizeNets();
+    // Bulk form of the add*() calls for parsers that intern net names themselves: ids index
+    // `net_names`, and each port list names a net at most once. Call finalizeNets() after.
+    void assignNets(std::vector<std::string> net_names, std::vector<NetType> net_types,
+                    std::vector<NetId> primary_inputs, std::vector<NetId> primary_outputs,
+                    std::vector<NetId> wires, std::vector<Gate> gates);
+
+    void finalizeNets(NetOrdering ordering = NetOrdering::ByName);
 
     const std::vector<NetId>& primaryInputs() const;
     const std::vector<NetId>& primaryOutputs() const;
@@ -58,6 +72,8 @@ public:
     const std::vector<std::string>& netNames() const;
     std::size_t netCount() const;
     const std::string& netName(NetId id) const;
+    // Net ids sorted by net name (the .ans order); the identity permutation for ByName.
+    const std::vector<NetId>& netsByName() const;
 
     bool hasNet(const std::string& net) const;
     NetType netType(const std::string& net) const;
@@ -68,6 +84,7 @@ public:
 
 private:
     NetId registerNet(const std::string& net, NetType type);
+    std::vector<NetId> localityOrder(const std::vector<NetId>& name_order) const;
 
     std::string name_;
     std::vector<NetId> primary_inputs_;
@@ -76,6 +93,7 @@ private:
     std::vector<Gate> gates_;
     std::vector<std::string> net_names_;
     std::vector<NetType> net_types_;
+    std::vector<NetId> nets_by_name_;
     std::unordered_map<std::string, NetId> net_lookup_;
 };
 
@@ -0,0 +1,236 @@
+#include "core/circuit_simplifier.hpp"
+
+#include <cstdint>
+#include <string>
+#include <utility>
+
+namespace core {
+
+namespace {
+
+constexpr int kNoGate = -1;
+
+GateType complement(GateType type) {
+    switch (type) {
+        case GateType::And:
+            return GateType::Nand;
+        case GateType::Nand:
+            return GateType::And;
+        case GateType::Or:
+            return GateType::Nor;
+        case GateType::Nor:
+            return GateType::Or;
+        case GateType::Xor:
+            return GateType::Xnor;
+        case GateType::Xnor:
+            return GateType::Xor;
+        case GateType::Not:
+            return GateType::Buf;
+        case GateType::Buf:
+            return GateType::Not;
+        case GateType::Unknown:
+        default:
+            return GateType::Unknown;
+    }
+}
+
+// Whether `inner` feeding `outer` can be flattened into one wider `outer` (possibly with
+// XOR/XNOR flipped, see simplifyCircuit).
+bool mergeable(GateType inner, GateType outer) {
+    switch (inner) {
+        case GateType::And:
+            return outer == GateType::And || outer == GateType::Nand;
+        case GateType::Or:
+            return outer == GateType::Or || outer == GateType::Nor;
+        case GateType::Xor:
+        case GateType::Xnor:
+            return outer == GateType::Xor || outer == GateType::Xnor;
+        default:
+            return false;
+    }
+}
+
+}  // namespace
+
+SimplifiedCircuit simplifyCircuit(const Circuit& circuit, const SimplifyOptions& options) {
+    const std::size_t net_count = circuit.netCount();
+    std::vector<Gate> gates = circuit.gates();
+    std::vector<std::uint8_t> alive(gates.size(), 1);
+    std::vector<int> driver(net_count, kNoGate);
+    std::vector<std::size_t> readers(net_count, 0);
+    std::vector<std::uint8_t> is_input(net_count, 0);
+    std::vector<std::uint8_t> is_output(net_count, 0);
+    for (std::size_t g = 0; g < gates.size(); ++g) {
+        driver[gates[g].output] = static_cast<int>(g);
+        for (const NetId net : gates[g].inputs) {
+            ++readers[net];
+        }
+    }
+    for (const NetId pi : circuit.primaryInputs()) {
+        is_input[pi] = 1;
+    }
+    for (const NetId po : circuit.primaryOutputs()) {
+        is_output[po] = 1;
+    }
+
+    // Until resolved below, an eliminated net points at the original net replacing it.
+    std::vector<NetAlias> link(net_count);
+    std::vector<std::uint8_t> eliminated(net_count, 0);
+    SimplifiedCircuit result;
+
+    // Absorbing a gate never changes the fan-in side of the gates still to be visited, so
+    // one pass in any order folds whole chains.
+    for (std::size_t g = 0; g < gates.size(); ++g) {
+        const GateType type = gates[g].type;
+        if ((type != GateType::Buf && type != GateType::Not) || gates[g].inputs.size() != 1) {
+            continue;
+        }
+        const NetId in = gates[g].inputs.front();
+        const NetId out = gates[g].output;
+        if (readers[in] != 1 || is_output[in] || in == out) {
+            continue;
+        }
+        const int source = driver[in];
+        if (source != kNoGate && !is_input[in]) {
+            auto& absorber = gates[static_cast<std::size_t>(source)];
+            absorber.output = out;
+            if (type == GateType::Not) {
+                absorber.type = complement(absorber.type);
+            }
+            driver[out] = source;
+            driver[in] = kNoGate;
+            link[in] = {out, type == GateType::Not};
+            eliminated[in] = 1;
+        } else if (type == GateType::Buf && !is_output[out] && !is_input[out]) {
+            // Readers of the BUF output are rewired to its input below; `in` may itself be a
+            // bypassed BUF output, so the count goes to the net they finally read.
+            NetId root = in;
+            while (eliminated[root]) {
+                root = link[root].net;
+            }
+            driver[out] = kNoGate;
+            readers[root] = readers[out];
+            link[out] = {in, false};
+            eliminated[out] = 1;
+        } else {
+            continue;
+        }
+        alive[g] = 0;
+        ++result.folded_gates;
+    }
+
+    // Follows links to the surviving net, accumulating polarity; merged nets stay kMergedNet.
+    auto resolve = [&](NetId net) {
+        NetAlias alias{net, false};
+        while (alias.net != NetAlias::kMergedNet && eliminated[alias.net]) {
+            const NetAlias next = link[alias.net];
+            alias = {next.net, alias.inverted != next.inverted};
+        }
+        return alias;
+    };
+    for (std::size_t g = 0; g < gates.size(); ++g) {
+        if (alive[g]) {
+            for (NetId& net : gates[g].inputs) {
+                net = resolve(net).net;
+            }
+        }
+    }
+
+    if (options.merge_gates) {
+        std::vector<int> reader(net_count, kNoGate);
+        for (std::size_t g = 0; g < gates.size(); ++g) {
+            if (alive[g]) {
+                for (const NetId net : gates[g].inputs) {
+                    reader[net] = static_cast<int>(g);
+                }
+            }
+        }
+        for (std::size_t g = 0; g < gates.size(); ++g) {
+            const NetId out = gates[g].output;
+            const int target = reader[out];
+            if (!alive[g] || readers[out] != 1 || is_output[out] || is_input[out] ||
+                target == kNoGate || target == static_cast<int>(g)) {
+                continue;
+            }
+            auto& outer = gates[static_cast<std::size_t>(target)];
+            if (!mergeable(gates[g].type, outer.type)) {
+                continue;
+            }
+            // XNOR(a, b) feeding XOR(c, d) is XNOR(a, b, c, d).
+            if (gates[g].type == GateType::Xnor) {
+                outer.type = complement(outer.type);
+            }
+            std::vector<NetId> inputs;
+            inputs.reserve(outer.inputs.size() + gates[g].inputs.size() - 1);
+            for (const NetId net : outer.inputs) {
+                if (net == out) {
+                    inputs.insert(inputs.end(), gates[g].inputs.begin(), gates[g].inputs.end());
+                } else {
+                    inputs.push_back(net);
+                }
+            }
+            outer.inputs = std::move(inputs);
+            for (const NetId net : gates[g].inputs) {
+                if (readers[net] == 1) {
+                    reader[net] = target;
+                }
+            }
+            alive[g] = 0;
+            driver[out] = kNoGate;
+            link[out] = {NetAlias::kMergedNet, false};
+            eliminated[out] = 1;
+            ++result.merged_gates;
+        }
+    }
+
+    // Surviving nets are renumbered densely here and by name in finalizeNets().
+    std::vector<NetId> dense(net_count, NetAlias::kMergedNet);
+    std::vector<std::string> names;
+    std::vector<NetType> types;
+    for (NetId net = 0; net < net_count; ++net) {
+        if (!eliminated[net]) {
+            dense[net] = names.size();
+            names.push_back(circuit.netName(net));
+            types.push_back(circuit.netType(net));
+        }
+    }
+    auto remap = [&](const std::vector<NetId>& nets) {
+        std::vector<NetId> mapped;
+        mapped.reserve(nets.size());
+        for (const NetId net : nets) {
+            if (!eliminated[net]) {
+                mapped.push_back(dense[net]);
+            }
+        }
+        return mapped;
+    };
+    std::vector<Gate> kept;
+    kept.reserve(gates.size() - result.folded_gates - result.merged_gates);
+    for (std::size_t g = 0; g < gates.size(); ++g) {
+        if (alive[g]) {
+            Gate gate = std::move(gates[g]);
+            gate.output = dense[gate.output];
+            for (NetId& net : gate.inputs) {
+                net = dense[net];
+            }
+            kept.push_back(std::move(gate));
+        }
+    }
+
+    result.circuit.setName(circuit.name());
+    result.circuit.assignNets(std::move(names), std::move(types), remap(circuit.primaryInputs()),
+                              remap(circuit.primaryOutputs()), remap(circuit.wires()),
+                              std::move(kept));
+    result.circuit.finalizeNets();
+
+    result.alias.resize(net_count);
+    for (NetId net = 0; net < net_count; ++net) {
+        const NetAlias alias = resolve(net);
+        if (alias.net != NetAlias::kMergedNet) {
+            result.alias[net] = {result.circuit.netId(circuit.netName(alias.net)), alias.inverted};
+        }
+    }
+    return result;
+}
+
+}  // namespace core
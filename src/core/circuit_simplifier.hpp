@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+#include "core/circuit.hpp"
+
+namespace core {
+
+// Where an original net's value lives in the simplified circuit: value(original) ==
+// value(net) ^ inverted. `net` is kMergedNet for nets only merge_gates removes.
+struct NetAlias {
+    static constexpr NetId kMergedNet = std::numeric_limits<NetId>::max();
+
+    NetId net{kMergedNet};
+    bool inverted{false};
+};
+
+struct SimplifyOptions {
+    // Also absorb single-fanout AND/OR/XOR gates into a consumer of the same family. The
+    // absorbed nets lose their alias, so only good-machine (output value) simulation may use
+    // the result.
+    bool merge_gates{false};
+};
+
+struct SimplifiedCircuit {
+    Circuit circuit;
+    std::vector<NetAlias> alias;  // indexed by original NetId
+    std::size_t folded_gates{0};
+    std::size_t merged_gates{0};
+};
+
+// Removes BUF/NOT gates whose input net feeds nothing else and is not a primary output: the
+// gate driving that net takes over the BUF/NOT output, complementing its type for NOT
+// (NAND -> AND, NOT -> BUF, ...), and a BUF on a primary input is bypassed. The folded net and
+// the one it is folded into carry equivalent stuck-at faults, so SA<v> on an original net is
+// SA<v ^ inverted> on its alias and fault engines can grade the smaller circuit.
+//
+// Primary inputs and outputs always survive, unaliased and in their original order, so
+// patterns and output words line up with the original circuit. Nets are numbered by name.
+SimplifiedCircuit simplifyCircuit(const Circuit& circuit, const SimplifyOptions& options = {});
+
+}  // namespace core
@@ -0,0 +1,174 @@
+#include "core/netlist_generator.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+#include <random>
+#include <stdexcept>
+
+namespace core {
+
+namespace {
+
+// Tries per side input before the fan-out cap is ignored.
+constexpr int kSideInputAttempts = 8;
+
+GateType pickMultiInputType(std::mt19937_64& rng, double xor_fraction) {
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    if (unit(rng) < xor_fraction) {
+        return unit(rng) < 0.5 ? GateType::Xor : GateType::Xnor;
+    }
+    // Roughly the AND/NAND/OR/NOR mix of the ISCAS-85 netlists.
+    const double u = unit(rng);
+    if (u < 0.35) {
+        return GateType::And;
+    }
+    if (u < 0.80) {
+        return GateType::Nand;
+    }
+    return u < 0.95 ? GateType::Or : GateType::Nor;
+}
+
+}  // namespace
+
+SyntheticNetlist generateNetlist(const NetlistSpec& spec) {
+    const std::size_t gate_count = spec.gate_count;
+    const std::size_t input_count =
+        spec.input_count != 0 ? spec.input_count : std::max<std::size_t>(8, gate_count / 16);
+    std::size_t depth = spec.depth;
+    if (depth == 0) {
+        depth = 3 * static_cast<std::size_t>(std::bit_width(gate_count));
+    }
+    depth = std::min(depth, gate_count);
+    if (gate_count == 0 || depth == 0) {
+        throw std::invalid_argument("Synthetic netlist needs at least one gate");
+    }
+    if (input_count + gate_count > std::numeric_limits<std::uint32_t>::max()) {
+        throw std::invalid_argument("Synthetic netlist too large for 32-bit net ids");
+    }
+    if (spec.max_fanin < 2 || spec.max_fanout < 1) {
+        throw std::invalid_argument("Synthetic netlist needs max_fanin >= 2 and max_fanout >= 1");
+    }
+
+    SyntheticNetlist netlist;
+    netlist.input_count = input_count;
+    netlist.depth = depth;
+    netlist.types.reserve(gate_count);
+    netlist.input_begin.reserve(gate_count + 1);
+    netlist.input_begin.push_back(0);
+    netlist.inputs.reserve(gate_count * 2);
+
+    // Nets of level l are [level_begin[l], level_begin[l + 1]); level 0 holds the inputs.
+    std::vector<std::uint32_t> level_begin(depth + 2);
+    level_begin[1] = static_cast<std::uint32_t>(input_count);
+    for (std::size_t l = 1; l <= depth; ++l) {
+        const std::size_t width = gate_count / depth + (l <= gate_count % depth ? 1 : 0);
+        level_begin[l + 1] = level_begin[l] + static_cast<std::uint32_t>(width);
+    }
+
+    std::mt19937_64 rng(spec.seed);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::vector<std::uint32_t> fanout(input_count + gate_count, 0);
+    std::vector<std::uint32_t> below;
+    std::size_t below_next = 0;
+
+    auto netIn = [&](std::size_t level) {
+        std::uniform_int_distribution<std::uint32_t> pick(level_begin[level],
+                                                          level_begin[level + 1] - 1);
+        return pick(rng);
+    };
+    auto driverInput = [&](std::uint32_t net) {
+        const std::size_t gate = net - input_count;
+        const std::uint32_t begin = netlist.input_begin[gate];
+        const std::uint32_t count = netlist.input_begin[gate + 1] - begin;
+        std::uniform_int_distribution<std::uint32_t> pick(0, count - 1);
+        return netlist.inputs[begin + pick(rng)];
+    };
+
+    for (std::size_t level = 1; level <= depth; ++level) {
+        below.assign(level_begin[level] - level_begin[level - 1], 0);
+        for (std::size_t i = 0; i < below.size(); ++i) {
+            below[i] = level_begin[level - 1] + static_cast<std::uint32_t>(i);
+        }
+        std::shuffle(below.begin(), below.end(), rng);
+        below_next = 0;
+
+        for (std::uint32_t net = level_begin[level]; net < level_begin[level + 1]; ++net) {
+            GateType type;
+            std::size_t fanin = 1;
+            if (unit(rng) < spec.inverter_fraction) {
+                type = unit(rng) < 0.6 ? GateType::Not : GateType::Buf;
+            } else {
+                type = pickMultiInputType(rng, spec.xor_fraction);
+                fanin = 2;
+                while (fanin < spec.max_fanin && unit(rng) < 0.3) {
+                    ++fanin;
+                }
+            }
+
+            if (below_next == below.size()) {
+                std::shuffle(below.begin(), below.end(), rng);
+                below_next = 0;
+            }
+            const std::uint32_t first = below[below_next++];
+            const std::size_t begin = netlist.inputs.size();
+            netlist.inputs.push_back(first);
+            auto taken = [&](std::uint32_t candidate) {
+                return std::find(netlist.inputs.begin() + static_cast<std::ptrdiff_t>(begin),
+                                 netlist.inputs.end(), candidate) != netlist.inputs.end();
+            };
+
+            for (std::size_t k = 1; k < fanin; ++k) {
+                std::uint32_t chosen = 0;
+                bool found = false;
+                for (int attempt = 0; attempt < 2 * kSideInputAttempts && !found; ++attempt) {
+                    std::uint32_t candidate;
+                    if (first >= input_count && unit(rng) < spec.reconvergence) {
+                        // Climb one to three levels up the first input's cone.
+                        candidate = driverInput(first);
+                        for (int step = 1; step < 3 && candidate >= input_count &&
+                                           unit(rng) < 0.5;
+                             ++step) {
+                            candidate = driverInput(candidate);
+                        }
+                    } else {
+                        // Mostly the level just below, geometrically less often further up.
+                        std::size_t up = level - 1;
+                        while (up > 0 && unit(rng) < 0.5) {
+                            --up;
+                        }
+                        candidate = netIn(up);
+                    }
+                    const bool capped = attempt < kSideInputAttempts &&
+                                        fanout[candidate] >= spec.max_fanout;
+                    if (!capped && !taken(candidate)) {
+                        chosen = candidate;
+                        found = true;
+                    }
+                }
+                if (!found) {
+                    break;
+                }
+                netlist.inputs.push_back(chosen);
+            }
+            if (netlist.inputs.size() - begin == 1 && type != GateType::Not &&
+                type != GateType::Buf) {
+                type = GateType::Not;
+            }
+            for (std::size_t i = begin; i < netlist.inputs.size(); ++i) {
+                ++fanout[netlist.inputs[i]];
+            }
+            netlist.types.push_back(type);
+            netlist.input_begin.push_back(static_cast<std::uint32_t>(netlist.inputs.size()));
+        }
+    }
+
+    for (std::size_t net = input_count; net < fanout.size(); ++net) {
+        if (fanout[net] == 0) {
+            netlist.outputs.push_back(static_cast<std::uint32_t>(net));
+        }
+    }
+    return netlist;
+}
+
+}  // namespace core
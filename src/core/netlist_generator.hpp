@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "core/circuit.hpp"
+
+namespace core {
+
+// Shape of a random combinational netlist. Zero counts pick a default scaled to gate_count.
+struct NetlistSpec {
+    std::size_t gate_count{1000};
+    std::size_t input_count{0};  // default max(8, gate_count / 16)
+    std::size_t depth{0};        // default 3 * log2(gate_count), at most gate_count
+    std::size_t max_fanin{4};
+    std::size_t max_fanout{32};
+    double inverter_fraction{0.35};  // NOT/BUF share of all gates (about 40% in c7552)
+    double xor_fraction{0.05};       // XOR/XNOR share of the multi-input gates
+    double reconvergence{0.3};       // chance a side input is taken from the first input's cone
+    std::uint64_t seed{1};
+};
+
+// Nets 0 .. input_count - 1 are the primary inputs and net input_count + g is driven by gate
+// g, which reads inputs[input_begin[g] .. input_begin[g + 1]). Every net that nothing reads
+// is a primary output.
+struct SyntheticNetlist {
+    std::size_t input_count{0};
+    std::size_t depth{0};
+    std::vector<GateType> types;
+    std::vector<std::uint32_t> input_begin;
+    std::vector<std::uint32_t> inputs;
+    std::vector<std::uint32_t> outputs;
+
+    std::size_t gateCount() const { return types.size(); }
+};
+
+// Gates are spread evenly over `depth` levels. Each gate's first input cycles through a
+// shuffled copy of the level below, so every net there is read at least once when levels are
+// equally wide and the netlist is exactly `depth` deep. Side inputs are either a net a few
+// levels up the first input's cone (reconvergent fanout) or a net from a nearby level,
+// skipping nets that already reached max_fanout.
+SyntheticNetlist generateNetlist(const NetlistSpec& spec);
+
+}  // namespace core
@@ -0,0 +1,106 @@
+#include "core/observability.hpp"
+
+namespace core {
+
+namespace {
+
+constexpr int kNoGate = -1;
+
+}  // namespace
+
+Observability analyzeObservability(const Circuit& circuit, std::size_t max_output_set_words) {
+    const auto& gates = circuit.gates();
+    const auto& outputs = circuit.primaryOutputs();
+    const std::size_t net_count = circuit.netCount();
+    std::vector<int> driver(net_count, kNoGate);
+    for (std::size_t g = 0; g < gates.size(); ++g) {
+        driver[gates[g].output] = static_cast<int>(g);
+    }
+
+    Observability result;
+    result.observable.assign(net_count, 0);
+    result.gate_observable.assign(gates.size(), 0);
+    std::vector<NetId> stack;
+    for (const NetId po : outputs) {
+        if (!result.observable[po]) {
+            result.observable[po] = 1;
+            stack.push_back(po);
+        }
+    }
+    while (!stack.empty()) {
+        const NetId net = stack.back();
+        stack.pop_back();
+        ++result.observable_count;
+        if (driver[net] == kNoGate) {
+            continue;
+        }
+        const auto g = static_cast<std::size_t>(driver[net]);
+        result.gate_observable[g] = 1;
+        for (const NetId in : gates[g].inputs) {
+            if (!result.observable[in]) {
+                result.observable[in] = 1;
+                stack.push_back(in);
+            }
+        }
+    }
+
+    const std::size_t words = (outputs.size() + 63) / 64;
+    if (words == 0 || net_count * words > max_output_set_words) {
+        return result;
+    }
+    // Output sets flow from readers to drivers, so gates are visited in reverse dependency
+    // order; only observable gates carry anything.
+    std::vector<std::vector<std::size_t>> readers(net_count);
+    std::vector<std::size_t> pending(gates.size(), 0);
+    for (std::size_t g = 0; g < gates.size(); ++g) {
+        if (!result.gate_observable[g]) {
+            continue;
+        }
+        for (const NetId in : gates[g].inputs) {
+            readers[in].push_back(g);
+            if (driver[in] != kNoGate) {
+                ++pending[g];
+            }
+        }
+    }
+    std::vector<std::size_t> order;
+    order.reserve(gates.size());
+    for (std::size_t g = 0; g < gates.size(); ++g) {
+        if (result.gate_observable[g] && pending[g] == 0) {
+            order.push_back(g);
+        }
+    }
+    for (std::size_t head = 0; head < order.size(); ++head) {
+        for (const std::size_t next : readers[gates[order[head]].output]) {
+            if (--pending[next] == 0) {
+                order.push_back(next);
+            }
+        }
+    }
+    std::size_t observable_gates = 0;
+    for (const std::uint8_t flag : result.gate_observable) {
+        observable_gates += flag;
+    }
+    if (order.size() != observable_gates) {
+        return result;
+    }
+
+    result.output_words = words;
+    result.reachable_outputs.assign(net_count * words, 0);
+    for (std::size_t i = 0; i < outputs.size(); ++i) {
+        result.reachable_outputs[outputs[i] * words + i / 64] |= std::uint64_t{1} << (i % 64);
+    }
+    for (std::size_t k = order.size(); k-- > 0;) {
+        const auto& gate = gates[order[k]];
+        const std::uint64_t* from = &result.reachable_outputs[gate.output * words];
+        for (const NetId in : gate.inputs) {
+            std::uint64_t* to = &result.reachable_outputs[in * words];
+            for (std::size_t w = 0; w < words; ++w) {
+                to[w] |= from[w];
+            }
+        }
+    }
+    return result;
+}
+
+}  // namespace core
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "core/circuit.hpp"
+
+namespace core {
+
+// Structural cone-of-influence facts, computed once per circuit. A net with no path to any
+// primary output can never change one, so both of its stuck-at faults compare equal to the
+// good machine and engines fill their answers without simulating them.
+struct Observability {
+    std::vector<std::uint8_t> observable;       // indexed by NetId
+    std::vector<std::uint8_t> gate_observable;  // indexed like circuit.gates()
+    std::size_t observable_count{0};
+
+    // Per net, a bitset over primaryOutputs() indices of the outputs it reaches:
+    // output_words words at reachable_outputs[net * output_words]. Empty when the circuit
+    // has a loop or the table would exceed the word budget given to analyzeObservability().
+    std::size_t output_words{0};
+    std::vector<std::uint64_t> reachable_outputs;
+
+    bool hasOutputSets() const { return !reachable_outputs.empty(); }
+    // Conservatively true without output sets.
+    bool reaches(NetId net, std::size_t output_index) const {
+        if (!hasOutputSets()) {
+            return observable[net] != 0;
+        }
+        const std::uint64_t word = reachable_outputs[net * output_words + output_index / 64];
+        return ((word >> (output_index % 64)) & 1U) != 0;
+    }
+};
+
+// Default budget for the per-net output sets (32 MiB).
+constexpr std::size_t kObservabilityOutputSetWords = std::size_t{1} << 22;
+
+Observability analyzeObservability(const Circuit& circuit,
+                                   std::size_t max_output_set_words = kObservabilityOutputSetWords);
+
+}  // namespace core
@@ -32,7 +32,12 @@ std::string Pattern::toString(const Circuit& circuit) const {
         if (i != 0) {
             oss << ", ";
         }
-        oss << circuit.netName(assignments[i].net) << '=' << assignments[i].value;
+        oss << circuit.netName(assignments[i].net) << '=';
+        if (assignments[i].value == kValueX) {
+            oss << 'X';
+        } else {
+            oss << assignments[i].value;
+        }
     }
     return oss.str();
 }
@@ -10,6 +10,9 @@
 
 namespace core {
 
+// Pattern value for an unspecified (don't-care) input, written `X` in .in files.
+constexpr int kValueX = 2;
+
 struct PatternEntry {
     NetId net{};
     int value{};
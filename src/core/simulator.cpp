@@ -1,10 +1,180 @@
 #include "core/simulator.hpp"
 
+#include <algorithm>
 #include <stdexcept>
 
+#include "core/observability.hpp"
+
 namespace core {
 
-Simulator::Simulator(const Circuit& circuit) : circuit_(circuit) {}
+namespace {
+
+// Evaluates one gate across `words` consecutive lanes of a net-major value buffer.
+void evaluateGateWords(const Gate& gate, std::uint64_t* values, std::size_t words) {
+    const auto& inputs = gate.inputs;
+    if (inputs.empty()) {
+        throw std::runtime_error("Gate missing inputs during simulation");
+    }
+    std::uint64_t* out = values + gate.output * words;
+    const std::uint64_t* first = values + inputs.front() * words;
+    std::copy(first, first + words, out);
+
+    switch (gate.type) {
+        case GateType::And:
+        case GateType::Nand:
+            for (std::size_t i = 1; i < inputs.size(); ++i) {
+                const std::uint64_t* in = values + inputs[i] * words;
+                for (std::size_t w = 0; w < words; ++w) {
+                    out[w] &= in[w];
+                }
+            }
+            break;
+        case GateType::Or:
+        case GateType::Nor:
+            for (std::size_t i = 1; i < inputs.size(); ++i) {
+                const std::uint64_t* in = values + inputs[i] * words;
+                for (std::size_t w = 0; w < words; ++w) {
+                    out[w] |= in[w];
+                }
+            }
+            break;
+        case GateType::Xor:
+        case GateType::Xnor:
+            for (std::size_t i = 1; i < inputs.size(); ++i) {
+                const std::uint64_t* in = values + inputs[i] * words;
+                for (std::size_t w = 0; w < words; ++w) {
+                    out[w] ^= in[w];
+                }
+            }
+            break;
+        case GateType::Not:
+            if (inputs.size() != 1) {
+                throw std::runtime_error("NOT gate expects exactly one input");
+            }
+            break;
+        case GateType::Buf:
+            if (inputs.size() != 1) {
+                throw std::runtime_error("BUF gate expects exactly one input");
+            }
+            break;
+        case GateType::Unknown:
+        default:
+            throw std::runtime_error("Encountered unknown gate type during simulation");
+    }
+
+    if (gate.type == GateType::Nand || gate.type == GateType::Nor ||
+        gate.type == GateType::Xnor || gate.type == GateType::Not) {
+        for (std::size_t w = 0; w < words; ++w) {
+            out[w] = ~out[w];
+        }
+    }
+}
+
+}  // namespace
+
+PackedPatterns PackedPatterns::pack(const Circuit& circuit, const std::vector<Pattern>& patterns,
+                                    std::size_t first, std::size_t count) {
+    if (first + count > patterns.size()) {
+        throw std::runtime_error("Pattern range out of bounds for packing");
+    }
+    const auto& inputs = circuit.primaryInputs();
+    std::vector<int> input_index(circuit.netCount(), -1);
+    for (std::size_t i = 0; i < inputs.size(); ++i) {
+        input_index[inputs[i]] = static_cast<int>(i);
+    }
+
+    PackedPatterns packed;
+    packed.pattern_count = count;
+    packed.word_count = (count + 63) / 64;
+    packed.inputs.assign(inputs.size() * packed.word_count, 0);
+    std::vector<std::size_t> assigned(inputs.size(), 0);
+    for (std::size_t p = 0; p < count; ++p) {
+        const std::size_t word = p / 64;
+        const std::uint64_t bit = std::uint64_t{1} << (p % 64);
+        for (const auto& entry : patterns[first + p].assignments) {
+            if (entry.value != 0 && entry.value != 1) {
+                throw std::runtime_error("Pattern contains non-binary value for net");
+            }
+            if (entry.net >= input_index.size() || input_index[entry.net] < 0) {
+                throw std::runtime_error("Packed patterns may only assign primary inputs");
+            }
+            const auto idx = static_cast<std::size_t>(input_index[entry.net]);
+            if (entry.value) {
+                packed.inputs[idx * packed.word_count + word] |= bit;
+            }
+            ++assigned[idx];
+        }
+    }
+    for (std::size_t i = 0; i < inputs.size(); ++i) {
+        if (assigned[i] != count) {
+            throw std::runtime_error("Pattern missing assignment for primary input");
+        }
+    }
+    return packed;
+}
+
+Simulator::Simulator(const Circuit& circuit) : circuit_(circuit) {
+    buildTopologicalOrder();
+}
+
+void Simulator::buildTopologicalOrder() {
+    const auto& gates = circuit_.gates();
+    const std::size_t net_count = circuit_.netCount();
+    const std::size_t no_driver = std::numeric_limits<std::size_t>::max();
+
+    std::vector<std::size_t> driver(net_count, no_driver);
+    for (std::size_t i = 0; i < gates.size(); ++i) {
+        driver[gates[i].output] = i;
+    }
+    std::vector<bool> is_input(net_count, false);
+    for (auto pi : circuit_.primaryInputs()) {
+        is_input[pi] = true;
+    }
+
+    std::vector<std::vector<std::size_t>> fanout(gates.size());
+    std::vector<std::size_t> pending(gates.size(), 0);
+    has_floating_inputs_ = false;
+    for (std::size_t i = 0; i < gates.size(); ++i) {
+        for (NetId net : gates[i].inputs) {
+            if (is_input[net]) {
+                continue;
+            }
+            if (driver[net] == no_driver) {
+                has_floating_inputs_ = true;
+                continue;
+            }
+            fanout[driver[net]].push_back(i);
+            ++pending[i];
+        }
+    }
+
+    topo_order_.clear();
+    topo_order_.reserve(gates.size());
+    for (std::size_t i = 0; i < gates.size(); ++i) {
+        if (pending[i] == 0) {
+            topo_order_.push_back(i);
+        }
+    }
+    for (std::size_t head = 0; head < topo_order_.size(); ++head) {
+        for (std::size_t next : fanout[topo_order_[head]]) {
+            if (--pending[next] == 0) {
+                topo_order_.push_back(next);
+            }
+        }
+    }
+    has_loop_ = topo_order_.size() != gates.size();
+
+    const Observability observability = analyzeObservability(circuit_, 0);
+    observed_order_.clear();
+    unobserved_nets_.clear();
+    for (const std::size_t gate_index : topo_order_) {
+        if (observability.gate_observable[gate_index]) {
+            observed_order_.push_back(gate_index);
+        } else {
+            unobserved_nets_.push_back(gates[gate_index].output);
+        }
+    }
+}
 
 SimulationResult Simulator::simulate(const Pattern& pattern) const {
     return simulateInternal(pattern, nullptr);
@@ -30,6 +200,51 @@ std::vector<SimulationResult> Simulator::simulate(const std::vector<Pattern>& pa
     return results;
 }
 
+void Simulator::simulateWords(const PackedPatterns& patterns,
+                              std::vector<std::uint64_t>& po_words,
+                              std::vector<std::uint64_t>* net_words) const {
+    if (has_loop_ || has_floating_inputs_) {
+        throw std::runtime_error(
+            "Unable to resolve all gates; check for combinational loops or missing nets.");
+    }
+    const std::size_t words = patterns.word_count;
+    const auto& inputs = circuit_.primaryInputs();
+    if (patterns.inputs.size() != inputs.size() * words) {
+        throw std::runtime_error("Packed patterns do not match circuit inputs");
+    }
+
+    thread_local std::vector<std::uint64_t> scratch;
+    std::vector<std::uint64_t>& values = net_words ? *net_words : scratch;
+    values.resize(circuit_.netCount() * words);
+    for (std::size_t i = 0; i < inputs.size(); ++i) {
+        std::copy_n(patterns.inputs.begin() + static_cast<std::ptrdiff_t>(i * words), words,
+                    values.begin() + static_cast<std::ptrdiff_t>(inputs[i] * words));
+    }
+
+    const auto& gates = circuit_.gates();
+    for (std::size_t gate_index : observed_order_) {
+        evaluateGateWords(gates[gate_index], values.data(), words);
+    }
+    for (const NetId net : unobserved_nets_) {
+        std::fill_n(values.begin() + static_cast<std::ptrdiff_t>(net * words), words, 0);
+    }
+
+    const std::size_t tail = patterns.pattern_count % 64;
+    if (tail != 0 && words > 0) {
+        const std::uint64_t mask = (std::uint64_t{1} << tail) - 1;
+        for (std::size_t net = 0; net < circuit_.netCount(); ++net) {
+            values[net * words + words - 1] &= mask;
+        }
+    }
+
+    const auto& outputs = circuit_.primaryOutputs();
+    po_words.resize(outputs.size() * words);
+    for (std::size_t i = 0; i < outputs.size(); ++i) {
+        std::copy_n(values.begin() + static_cast<std::ptrdiff_t>(outputs[i] * words), words,
+                    po_words.begin() + static_cast<std::ptrdiff_t>(i * words));
+    }
+}
+
 int Simulator::evaluateGateValue(GateType type, const std::vector<int>& values) const {
     if (values.empty()) {
         throw std::runtime_error("Gate missing inputs during simulation");
@@ -89,12 +304,12 @@ int Simulator::evaluateGateValue(GateType type, const std::vector<int>& values)
 
 SimulationResult Simulator::simulateInternal(const Pattern& pattern,
                                              const FaultSpec* fault) const {
+    if (has_loop_) {
+        throw std::runtime_error(
+            "Unable to resolve all gates; check for combinational loops or missing nets.");
+    }
     std::vector<int> values(circuit_.netCount(), -1);
 
-    auto isForcedNet = [&](NetId net) {
-        return fault != nullptr && net == fault->net;
-    };
-
     // Seed primary inputs.
     for (const auto& entry : pattern.assignments) {
         if (entry.value != 0 && entry.value != 1) {
@@ -103,11 +318,7 @@ SimulationResult Simulator::simulateInternal(const Pattern& pattern,
         if (entry.net == std::numeric_limits<NetId>::max() || entry.net >= values.size()) {
             throw std::runtime_error("Pattern references unknown net");
         }
-        int value = entry.value;
-        if (isForcedNet(entry.net)) {
-            value = fault->value;
-        }
-        values[entry.net] = value;
+        values[entry.net] = entry.value;
     }
 
     for (const auto& pi : circuit_.primaryInputs()) {
@@ -116,34 +327,29 @@ SimulationResult Simulator::simulateInternal(const Pattern& pattern,
         }
     }
 
-    if (fault && values[fault->net] == -1) {
+    if (fault) {
         values[fault->net] = fault->value;
     }
 
     const auto& gates = circuit_.gates();
-    std::vector<bool> evaluated(gates.size(), false);
-    std::size_t remaining = gates.size();
-
-    while (remaining > 0) {
-        bool progress = false;
-        for (std::size_t i = 0; i < gates.size(); ++i) {
-            if (evaluated[i]) {
-                continue;
-            }
-            if (tryEvaluateGate(gates[i], values, fault)) {
-                evaluated[i] = true;
-                --remaining;
-                progress = true;
-            }
+    std::vector<int> input_values;
+    for (std::size_t gate_index : topo_order_) {
+        const Gate& gate = gates[gate_index];
+        if (fault && gate.output == fault->net) {
+            continue;
         }
-        if (!progress) {
-            throw std::runtime_error(
-                "Unable to resolve all gates; check for combinational loops or missing nets.");
+        input_values.clear();
+        for (NetId net : gate.inputs) {
+            if (values[net] == -1) {
+                throw std::runtime_error(
+                    "Unable to resolve all gates; check for combinational loops or missing nets.");
+            }
+            input_values.push_back(values[net]);
         }
+        values[gate.output] = evaluateGateValue(gate.type, input_values);
     }
 
     SimulationResult result;
-    result.net_values = values;
     const auto& outputs = circuit_.primaryOutputs();
     result.primary_outputs.reserve(outputs.size());
     for (const auto& output : outputs) {
@@ -152,39 +358,8 @@ SimulationResult Simulator::simulateInternal(const Pattern& pattern,
         }
         result.primary_outputs.push_back(values[output]);
     }
+    result.net_values = std::move(values);
     return result;
 }
 
-bool Simulator::tryEvaluateGate(const Gate& gate,
-                                std::vector<int>& values,
-                                const FaultSpec* fault) const {
-    if (fault && gate.output == fault->net) {
-        values[gate.output] = fault->value;
-        return true;
-    }
-
-    std::vector<int> input_values;
-    input_values.reserve(gate.inputs.size());
-    for (NetId net : gate.inputs) {
-        const int value = values[net];
-        if (value == -1) {
-            if (fault && net == fault->net) {
-                values[net] = fault->value;
-                input_values.push_back(fault->value);
-                continue;
-            }
-            return false;
-        }
-        input_values.push_back(value);
-    }
-
-    const int gate_value = evaluateGateValue(gate.type, input_values);
-    if (fault && gate.output == fault->net) {
-        values[gate.output] = fault->value;
-    } else {
-        values[gate.output] = gate_value;
-    }
-    return true;
-}
-
 }  // namespace core
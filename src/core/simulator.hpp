@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <limits>
 #include <vector>
 
@@ -18,6 +20,17 @@ struct FaultSpec {
     int value{};
 };
 
+// Patterns transposed into 64-lane words: word w of primary input i (stored at
+// inputs[i * word_count + w]) holds patterns 64 * w .. 64 * w + 63.
+struct PackedPatterns {
+    std::size_t pattern_count{0};
+    std::size_t word_count{0};
+    std::vector<std::uint64_t> inputs;
+
+    static PackedPatterns pack(const Circuit& circuit, const std::vector<Pattern>& patterns,
+                               std::size_t first, std::size_t count);
+};
+
 class Simulator {
 public:
     explicit Simulator(const Circuit& circuit);
@@ -26,14 +39,31 @@ public:
     SimulationResult simulateFault(const Pattern& pattern, const FaultSpec& fault) const;
     std::vector<SimulationResult> simulate(const std::vector<Pattern>& patterns) const;
 
+    // Good-machine simulation of every packed pattern in one topological pass. Buffers are
+    // caller-owned and only grow: `po_words` receives primaryOutputs().size() * word_count
+    // words (output-major); `net_words`, when given, receives netCount() * word_count words
+    // (net-major). Lanes past pattern_count are zero. Only gates in the fan-in of some
+    // primary output are evaluated; nets they do not drive read as zero.
+    void simulateWords(const PackedPatterns& patterns, std::vector<std::uint64_t>& po_words,
+                       std::vector<std::uint64_t>* net_words = nullptr) const;
+
 private:
     const Circuit& circuit_;
+    // Gates in dependency order, computed once. Nets read by a gate but driven by nothing
+    // (and not primary inputs) are leaves that only a pattern or fault can resolve.
+    std::vector<std::size_t> topo_order_;
+    // topo_order_ restricted to gates that can reach a primary output, and the nets driven
+    // by the others.
+    std::vector<std::size_t> observed_order_;
+    std::vector<NetId> unobserved_nets_;
+    bool has_loop_{false};
+    bool has_floating_inputs_{false};
+
+    void buildTopologicalOrder();
 
     SimulationResult simulateInternal(const Pattern& pattern,
                                       const FaultSpec* fault) const;
     int evaluateGateValue(GateType type, const std::vector<int>& values) const;
-    bool tryEvaluateGate(const Gate& gate, std::vector<int>& values,
-                         const FaultSpec* fault) const;
 };
 
 }  // namespace core
@@ -0,0 +1,312 @@
+#include "core/truth_table.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+namespace core {
+
+namespace {
+
+constexpr std::uint32_t kUnset = std::numeric_limits<std::uint32_t>::max();
+constexpr int kNoGate = -1;
+
+bool inverting(GateType type) {
+    return type == GateType::Nand || type == GateType::Nor || type == GateType::Xnor ||
+           type == GateType::Not;
+}
+
+// The non-inverting gate of the same family, used for the inner links of a split gate.
+GateType family(GateType type) {
+    switch (type) {
+        case GateType::Nand:
+            return GateType::And;
+        case GateType::Nor:
+            return GateType::Or;
+        case GateType::Xnor:
+            return GateType::Xor;
+        case GateType::Not:
+            return GateType::Buf;
+        default:
+            return type;
+    }
+}
+
+// Truth table of `type` over `arity` inputs, input 0 being the most significant index bit.
+// BUF/NOT look at input 0 only.
+std::uint8_t tableFor(GateType type, unsigned arity) {
+    std::uint8_t table = 0;
+    for (unsigned index = 0; index < (1U << arity); ++index) {
+        unsigned value = 0;
+        unsigned ones = 0;
+        for (unsigned k = 0; k < arity; ++k) {
+            ones += (index >> (arity - 1 - k)) & 1U;
+        }
+        switch (family(type)) {
+            case GateType::And:
+                value = ones == arity ? 1 : 0;
+                break;
+            case GateType::Or:
+                value = ones != 0 ? 1 : 0;
+                break;
+            case GateType::Xor:
+                value = ones & 1U;
+                break;
+            case GateType::Buf:
+                value = (index >> (arity - 1)) & 1U;
+                break;
+            default:
+                throw std::runtime_error("Unknown gate type encountered during simulation");
+        }
+        if (inverting(type)) {
+            value ^= 1U;
+        }
+        table = static_cast<std::uint8_t>(table | (value << index));
+    }
+    return table;
+}
+
+// A 4-bit table in algebraic normal form: f(a, b) = c ^ (ca & a) ^ (cb & b) ^ (cab & a & b),
+// each coefficient widened to an all-zeros/all-ones word.
+struct Anf {
+    std::uint64_t c;
+    std::uint64_t ca;
+    std::uint64_t cb;
+    std::uint64_t cab;
+};
+
+inline Anf anfOf(unsigned t) {
+    const unsigned f00 = t & 1U;
+    const unsigned f01 = (t >> 1) & 1U;
+    const unsigned f10 = (t >> 2) & 1U;
+    const unsigned f11 = (t >> 3) & 1U;
+    return {std::uint64_t{0} - f00, std::uint64_t{0} - (f00 ^ f10),
+            std::uint64_t{0} - (f00 ^ f01), std::uint64_t{0} - (f00 ^ f01 ^ f10 ^ f11)};
+}
+
+inline std::uint64_t eval2(const Anf& f, std::uint64_t a, std::uint64_t b) {
+    return f.c ^ (f.ca & a) ^ (f.cb & b) ^ (f.cab & a & b);
+}
+
+// Shannon expansion on a: the high nibble is f(1, b, c), the low one f(0, b, c).
+inline std::uint64_t eval3(const Anf& hi, const Anf& lo, std::uint64_t a, std::uint64_t b,
+                           std::uint64_t c) {
+    const std::uint64_t when0 = eval2(lo, b, c);
+    return when0 ^ (a & (eval2(hi, b, c) ^ when0));
+}
+
+}  // namespace
+
+TruthTableSimulator::TruthTableSimulator(const Circuit& circuit) : circuit_(circuit) {
+    const auto& gates = circuit_.gates();
+    const auto& inputs = circuit_.primaryInputs();
+    const std::size_t net_count = circuit_.netCount();
+    input_count_ = inputs.size();
+
+    // Nodes are primary inputs [0, input_count_) followed by ops in creation order.
+    std::vector<std::uint32_t> node_of_net(net_count, kUnset);
+    for (std::size_t i = 0; i < inputs.size(); ++i) {
+        node_of_net[inputs[i]] = static_cast<std::uint32_t>(i);
+    }
+
+    std::vector<int> driver(net_count, kNoGate);
+    for (std::size_t g = 0; g < gates.size(); ++g) {
+        driver[gates[g].output] = static_cast<int>(g);
+    }
+    std::vector<std::vector<std::size_t>> readers(net_count);
+    std::vector<std::size_t> pending(gates.size(), 0);
+    for (std::size_t g = 0; g < gates.size(); ++g) {
+        for (const NetId net : gates[g].inputs) {
+            if (node_of_net[net] != kUnset) {
+                continue;
+            }
+            if (driver[net] == kNoGate) {
+                throw std::runtime_error("Truth-table simulation found an undriven gate input");
+            }
+            readers[net].push_back(g);
+            ++pending[g];
+        }
+    }
+    std::vector<std::size_t> order;
+    order.reserve(gates.size());
+    for (std::size_t g = 0; g < gates.size(); ++g) {
+        if (pending[g] == 0) {
+            order.push_back(g);
+        }
+    }
+    for (std::size_t head = 0; head < order.size(); ++head) {
+        for (const std::size_t next : readers[gates[order[head]].output]) {
+            if (--pending[next] == 0) {
+                order.push_back(next);
+            }
+        }
+    }
+    if (order.size() != gates.size()) {
+        throw std::runtime_error("Truth-table simulation requires an acyclic circuit");
+    }
+
+    struct Op {
+        std::uint32_t in[3];
+        unsigned arity;
+        std::uint8_t table;
+        std::uint32_t level;
+    };
+    std::vector<Op> ops;
+    ops.reserve(gates.size());
+    std::vector<std::uint32_t> level(input_count_, 0);
+    auto emit = [&](GateType type, unsigned arity, std::uint32_t a, std::uint32_t b,
+                    std::uint32_t c) {
+        const std::uint32_t op_level =
+            1 + std::max({level[a], level[b], arity == 3 ? level[c] : std::uint32_t{0}});
+        ops.push_back({{a, b, c}, arity, tableFor(type, arity), op_level});
+        level.push_back(op_level);
+        return static_cast<std::uint32_t>(level.size() - 1);
+    };
+
+    for (const std::size_t g : order) {
+        const Gate& gate = gates[g];
+        const std::size_t fanin = gate.inputs.size();
+        if (fanin == 0) {
+            throw std::runtime_error("Gate missing inputs during simulation");
+        }
+        if ((gate.type == GateType::Not || gate.type == GateType::Buf) && fanin != 1) {
+            throw std::runtime_error("NOT/BUF gate expects exactly one input");
+        }
+        std::vector<std::uint32_t> in(fanin);
+        for (std::size_t k = 0; k < fanin; ++k) {
+            in[k] = node_of_net[gate.inputs[k]];
+        }
+        std::uint32_t node = 0;
+        if (fanin == 1) {
+            // A one-input AND/OR/XOR passes its input through.
+            node = emit(inverting(gate.type) ? GateType::Not : GateType::Buf, 2, in[0], in[0], 0);
+        } else if (fanin == 2) {
+            node = emit(gate.type, 2, in[0], in[1], 0);
+        } else if (fanin == 3) {
+            node = emit(gate.type, 3, in[0], in[1], in[2]);
+        } else {
+            node = emit(family(gate.type), 3, in[0], in[1], in[2]);
+            std::size_t k = 3;
+            while (k < fanin) {
+                const std::size_t remaining = fanin - k;
+                if (remaining >= 2) {
+                    const GateType type = remaining == 2 ? gate.type : family(gate.type);
+                    node = emit(type, 3, node, in[k], in[k + 1]);
+                    k += 2;
+                } else {
+                    node = emit(gate.type, 2, node, in[k], 0);
+                    k += 1;
+                }
+            }
+        }
+        node_of_net[gate.output] = node;
+    }
+
+    // Level-major, 2-input ops before 3-input ops within a level.
+    std::vector<std::uint32_t> rank(ops.size());
+    std::iota(rank.begin(), rank.end(), 0);
+    std::stable_sort(rank.begin(), rank.end(), [&](std::uint32_t x, std::uint32_t y) {
+        return ops[x].level != ops[y].level ? ops[x].level < ops[y].level
+                                            : ops[x].arity < ops[y].arity;
+    });
+    std::vector<std::uint32_t> slot_of_node(input_count_ + ops.size());
+    std::iota(slot_of_node.begin(), slot_of_node.begin() + static_cast<std::ptrdiff_t>(input_count_),
+              0);
+    for (std::size_t pos = 0; pos < rank.size(); ++pos) {
+        slot_of_node[input_count_ + rank[pos]] = static_cast<std::uint32_t>(input_count_ + pos);
+    }
+    slot_count_ = input_count_ + ops.size();
+
+    in_a_.resize(ops.size());
+    in_b_.resize(ops.size());
+    in_c_.resize(ops.size());
+    table_.resize(ops.size());
+    for (std::size_t pos = 0; pos < rank.size(); ++pos) {
+        const Op& op = ops[rank[pos]];
+        in_a_[pos] = slot_of_node[op.in[0]];
+        in_b_[pos] = slot_of_node[op.in[1]];
+        in_c_[pos] = op.arity == 3 ? slot_of_node[op.in[2]] : 0;
+        table_[pos] = op.table;
+        if (batches_.empty() || ops[rank[batches_.back().begin]].level != op.level ||
+            batches_.back().arity != op.arity) {
+            batches_.push_back({pos, pos, op.arity});
+        }
+        batches_.back().end = pos + 1;
+    }
+
+    for (const NetId po : circuit_.primaryOutputs()) {
+        if (node_of_net[po] == kUnset) {
+            throw std::runtime_error("Unable to resolve primary output");
+        }
+        output_slots_.push_back(slot_of_node[node_of_net[po]]);
+    }
+}
+
+void TruthTableSimulator::simulateWords(const PackedPatterns& patterns,
+                                        std::vector<std::uint64_t>& po_words) const {
+    const std::size_t words = patterns.word_count;
+    if (patterns.inputs.size() != input_count_ * words) {
+        throw std::runtime_error("Packed patterns do not match circuit inputs");
+    }
+
+    thread_local std::vector<std::uint64_t> scratch;
+    scratch.resize(slot_count_ * words);
+    std::uint64_t* values = scratch.data();
+    // Packed inputs are already input-major, the layout of slots [0, input_count_).
+    std::copy(patterns.inputs.begin(), patterns.inputs.end(), values);
+
+    const std::uint32_t* in_a = in_a_.data();
+    const std::uint32_t* in_b = in_b_.data();
+    const std::uint32_t* in_c = in_c_.data();
+    const std::uint8_t* table = table_.data();
+    std::uint64_t* out = values + input_count_ * words;
+    for (const Batch& batch : batches_) {
+        if (words == 1) {
+            // One word per slot: a gather-load, contiguous-store loop over the batch.
+            if (batch.arity == 2) {
+                for (std::size_t i = batch.begin; i < batch.end; ++i) {
+                    out[i] = eval2(anfOf(table[i]), values[in_a[i]], values[in_b[i]]);
+                }
+            } else {
+                for (std::size_t i = batch.begin; i < batch.end; ++i) {
+                    out[i] = eval3(anfOf(table[i] >> 4), anfOf(table[i] & 0xFU), values[in_a[i]],
+                                   values[in_b[i]], values[in_c[i]]);
+                }
+            }
+            continue;
+        }
+        for (std::size_t i = batch.begin; i < batch.end; ++i) {
+            const std::uint64_t* a = values + in_a[i] * words;
+            const std::uint64_t* b = values + in_b[i] * words;
+            std::uint64_t* o = out + i * words;
+            if (batch.arity == 2) {
+                const Anf f = anfOf(table[i]);
+                for (std::size_t w = 0; w < words; ++w) {
+                    o[w] = eval2(f, a[w], b[w]);
+                }
+            } else {
+                const std::uint64_t* c = values + in_c[i] * words;
+                const Anf hi = anfOf(table[i] >> 4);
+                const Anf lo = anfOf(table[i] & 0xFU);
+                for (std::size_t w = 0; w < words; ++w) {
+                    o[w] = eval3(hi, lo, a[w], b[w], c[w]);
+                }
+            }
+        }
+    }
+
+    const std::size_t tail = patterns.pattern_count % 64;
+    const std::uint64_t last_mask =
+        tail == 0 ? ~std::uint64_t{0} : (std::uint64_t{1} << tail) - 1;
+    po_words.resize(output_slots_.size() * words);
+    for (std::size_t i = 0; i < output_slots_.size(); ++i) {
+        std::copy_n(values + output_slots_[i] * words, words,
+                    po_words.begin() + static_cast<std::ptrdiff_t>(i * words));
+        if (words > 0) {
+            po_words[i * words + words - 1] &= last_mask;
+        }
+    }
+}
+
+}  // namespace core
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "core/circuit.hpp"
+#include "core/simulator.hpp"
+
+namespace core {
+
+// Good-machine simulation without a switch on GateType. Every gate becomes one or more 2- or
+// 3-input truth-table ops: a 2-input op carries the 4-bit code of batch_gpu_fault_common.cuh
+// (bit 3 = f(1,1), bit 2 = f(1,0), bit 1 = f(0,1), bit 0 = f(0,0)), NOT/BUF read their input
+// twice, 3-input ops carry an 8-entry table indexed by (a << 2 | b << 1 | c), and wider
+// gates are split into a chain of 3-input ops. Ops are grouped by level and arity, and the
+// op at position i of that order writes value slot input_count_ + i, so each batch is a
+// type-agnostic loop with contiguous stores.
+class TruthTableSimulator {
+public:
+    // Throws if the circuit has a loop or a gate input nothing drives.
+    explicit TruthTableSimulator(const Circuit& circuit);
+
+    // Same contract as Simulator::simulateWords without net words.
+    void simulateWords(const PackedPatterns& patterns, std::vector<std::uint64_t>& po_words) const;
+
+    std::size_t opCount() const { return table_.size(); }
+
+private:
+    struct Batch {
+        std::size_t begin{0};
+        std::size_t end{0};
+        unsigned arity{2};
+    };
+
+    const Circuit& circuit_;
+    std::size_t input_count_{0};
+    std::size_t slot_count_{0};
+    std::vector<Batch> batches_;
+    // Per op, in evaluation order: input slots (in_c_ unused for 2-input ops) and table.
+    std::vector<std::uint32_t> in_a_;
+    std::vector<std::uint32_t> in_b_;
+    std::vector<std::uint32_t> in_c_;
+    std::vector<std::uint8_t> table_;
+    std::vector<std::uint32_t> output_slots_;  // per primary output
+};
+
+}  // namespace core
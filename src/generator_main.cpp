@@ -1,26 +1,36 @@
 // Standalone pattern generator CLI.
 
+#include <algorithm>
 #include <cstdint>
-#include <cstdio>
 #include <cstdlib>
 #include <exception>
 #include <fstream>
 #include <iostream>
-#include <sstream>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
 #include "algorithm/bit_parallel_simulator.hpp"
+#include "core/circuit_simplifier.hpp"
+#include "core/netlist_generator.hpp"
 #include "core/pattern_generator.hpp"
 #include "core/simulator.hpp"
+#include "core/truth_table.hpp"
 #include "io/answer_writer.hpp"
 #include "io/circuit_parser.hpp"
+#include "io/netlist_writer.hpp"
 
 namespace {
 
 void printUsage(const char* program) {
     std::cerr << "Usage: " << program << " <circuit> [pattern-count=100] [seed=42]\n";
+    std::cerr << "       " << program << " --synth <name> <gate-count> [--inputs N] [--depth D]\n"
+              << "           [--max-fanin K] [--max-fanout M] [--inverters P] [--xor P]\n"
+              << "           [--reconvergence P] [--seed S] [--patterns N] [--no-answers]\n";
     std::cerr << "  circuit: basename or .v file located under testcases/\n";
+    std::cerr << "  --synth: write a random combinational netlist to testcases/<name>.v (see\n"
+                 "           core::NetlistSpec for the defaults), then generate its .in/.ans;\n"
+                 "           --no-answers stops after the .in\n";
 }
 
 bool endsWith(const std::string& value, const std::string& suffix) {
@@ -44,45 +54,183 @@ std::string circuitBaseName(const std::string& file_name) {
     return file_name;
 }
 
-std::string computeSha256(const std::string& file_path) {
-    const std::vector<std::string> commands = {"sha256sum ", "shasum -a 256 "};
-    for (const auto& base : commands) {
-        std::string command = base + file_path;
-        FILE* handle = popen(command.c_str(), "r");
-        if (!handle) {
-            continue;
-        }
-        std::string output;
-        char buffer[256];
-        while (fgets(buffer, sizeof(buffer), handle) != nullptr) {
-            output += buffer;
-        }
-        const int status = pclose(handle);
-        if (status != 0) {
+void writeShaFile(const std::string& digest, const std::string& sha_path) {
+    std::ofstream sha_file(sha_path);
+    if (!sha_file) {
+        throw std::runtime_error("Failed to open SHA output file: " + sha_path);
+    }
+    sha_file << digest << '\n';
+}
+
+// Writes testcases/<base>.in (inputs | golden outputs) and, when `write_answers`, the .ans and
+// .ans.sha graded by the bit-parallel engine.
+void generatePatterns(const std::string& circuit_file, std::size_t pattern_count,
+                      std::uint64_t seed, bool write_answers) {
+    const std::string circuit_path = "testcases/" + circuit_file;
+    const std::string output_path = "testcases/" + circuitBaseName(circuit_file) + ".in";
+
+    auto circuit = io::parseCircuit(circuit_path);
+    core::PatternGenerator generator(circuit, seed);
+    auto patterns = generator.generate(pattern_count);
+    // Golden outputs only need primary output values, so BUF/NOT chains and same-family gate
+    // trees are collapsed first; inputs and outputs keep their order, so packing is unchanged.
+    // The branch-free truth-table evaluator beats the per-gate switch at this block width.
+    const auto reduced = core::simplifyCircuit(circuit, {.merge_gates = true});
+    const core::TruthTableSimulator simulator(reduced.circuit);
+
+    const auto& inputs = circuit.primaryInputs();
+    const auto& outputs = circuit.primaryOutputs();
+    std::vector<std::string> input_prefix(circuit.netCount());
+    for (auto pi : inputs) {
+        input_prefix[pi] = circuit.netName(pi) + '=';
+    }
+    std::vector<std::string> output_prefix(outputs.size());
+    for (std::size_t j = 0; j < outputs.size(); ++j) {
+        output_prefix[j] = circuit.netName(outputs[j]) + '=';
+    }
+
+    // Golden outputs are simulated 512 patterns (8 words) per levelized pass; each block is
+    // also formatted into its own buffer so blocks can be produced in parallel and written
+    // in order.
+    constexpr std::size_t kBlock = 512;
+    const std::size_t block_count = (patterns.size() + kBlock - 1) / kBlock;
+    std::vector<std::string> text(block_count);
+    std::vector<io::PatternRow> rows(patterns.size());
+    std::exception_ptr failure;
+
+#pragma omp parallel for schedule(dynamic)
+    for (long long b = 0; b < static_cast<long long>(block_count); ++b) {
+        const std::size_t first = static_cast<std::size_t>(b) * kBlock;
+        const std::size_t count = std::min(kBlock, patterns.size() - first);
+        thread_local std::vector<std::uint64_t> golden;
+        std::size_t words = 0;
+        try {
+            const auto packed = core::PackedPatterns::pack(circuit, patterns, first, count);
+            simulator.simulateWords(packed, golden);
+            words = packed.word_count;
+        } catch (...) {
+#pragma omp critical
+            failure = std::current_exception();
             continue;
         }
-        std::istringstream iss(output);
-        std::string digest;
-        if (iss >> digest) {
-            return digest;
+
+        std::string& out = text[static_cast<std::size_t>(b)];
+        for (std::size_t lane = 0; lane < count; ++lane) {
+            const auto& pattern = patterns[first + lane];
+            for (std::size_t i = 0; i < pattern.assignments.size(); ++i) {
+                if (i != 0) {
+                    out += ", ";
+                }
+                out += input_prefix[pattern.assignments[i].net];
+                out += pattern.assignments[i].value ? '1' : '0';
+            }
+            out += " | ";
+
+            io::PatternRow& row = rows[first + lane];
+            row.pattern = pattern;
+            for (std::size_t j = 0; j < outputs.size(); ++j) {
+                const int value = static_cast<int>((golden[j * words + lane / 64] >> (lane % 64)) & 1U);
+                out += output_prefix[j];
+                out += value ? '1' : '0';
+                row.provided_outputs[outputs[j]] = value;
+                if (j + 1 != outputs.size()) {
+                    out += ", ";
+                }
+            }
+            out += '\n';
         }
     }
-    throw std::runtime_error(
-        "Unable to compute SHA-256 digest; sha256sum/shasum commands not found.");
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+
+    std::ofstream output(output_path, std::ios::binary);
+    if (!output) {
+        throw std::runtime_error("Failed to open output file for writing: " + output_path);
+    }
+    for (const auto& block : text) {
+        output.write(block.data(), static_cast<std::streamsize>(block.size()));
+    }
+    output.close();
+    std::cout << "Wrote " << patterns.size() << " patterns for " << circuit_file << " to "
+              << output_path << '\n';
+    if (!write_answers) {
+        return;
+    }
+
+    algorithm::BitParallelSimulator bit(circuit, rows);
+    bit.start();
+
+    const std::string ans_path = "testcases/" + circuitBaseName(circuit_file) + ".ans";
+    std::string digest;
+    io::writeAnswerFile(bit, ans_path, {}, &digest);
+    std::cout << "Wrote fault answers to " << ans_path << '\n';
+    const std::string sha_path = ans_path + ".sha";
+    writeShaFile(digest, sha_path);
+    std::cout << "Wrote SHA digest to " << sha_path << '\n';
 }
 
-void writeShaFile(const std::string& file_path, const std::string& sha_path) {
-    const std::string digest = computeSha256(file_path);
-    std::ofstream sha_file(sha_path);
-    if (!sha_file) {
-        throw std::runtime_error("Failed to open SHA output file: " + sha_path);
+int runSynth(int argc, char** argv) {
+    if (argc < 4) {
+        printUsage(argv[0]);
+        return EXIT_FAILURE;
     }
-    sha_file << digest << '\n';
+    const std::string name = argv[2];
+    core::NetlistSpec spec;
+    spec.gate_count = std::stoull(argv[3]);
+    std::size_t pattern_count = 100;
+    bool write_answers = true;
+    for (int i = 4; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        if (arg == "--inputs" && has_value) {
+            spec.input_count = std::stoull(argv[++i]);
+        } else if (arg == "--depth" && has_value) {
+            spec.depth = std::stoull(argv[++i]);
+        } else if (arg == "--max-fanin" && has_value) {
+            spec.max_fanin = std::stoull(argv[++i]);
+        } else if (arg == "--max-fanout" && has_value) {
+            spec.max_fanout = std::stoull(argv[++i]);
+        } else if (arg == "--inverters" && has_value) {
+            spec.inverter_fraction = std::stod(argv[++i]);
+        } else if (arg == "--xor" && has_value) {
+            spec.xor_fraction = std::stod(argv[++i]);
+        } else if (arg == "--reconvergence" && has_value) {
+            spec.reconvergence = std::stod(argv[++i]);
+        } else if (arg == "--seed" && has_value) {
+            spec.seed = std::stoull(argv[++i]);
+        } else if (arg == "--patterns" && has_value) {
+            pattern_count = std::stoull(argv[++i]);
+        } else if (arg == "--no-answers") {
+            write_answers = false;
+        } else {
+            printUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    const auto netlist = core::generateNetlist(spec);
+    const std::string circuit_file = circuitFileName(name);
+    const std::string circuit_path = "testcases/" + circuit_file;
+    io::writeVerilog(netlist, circuitBaseName(circuit_file), circuit_path);
+    std::cout << "Wrote " << netlist.gateCount() << " gates (" << netlist.input_count
+              << " inputs, " << netlist.outputs.size() << " outputs, depth " << netlist.depth
+              << ") to " << circuit_path << '\n';
+    generatePatterns(circuit_file, pattern_count, spec.seed, write_answers);
+    return EXIT_SUCCESS;
 }
 
 }  // namespace
 
 int main(int argc, char** argv) {
+    if (argc >= 2 && std::string(argv[1]) == "--synth") {
+        try {
+            return runSynth(argc, argv);
+        } catch (const std::exception& ex) {
+            std::cerr << "Error: " << ex.what() << '\n';
+            return EXIT_FAILURE;
+        }
+    }
     if (argc < 2) {
         printUsage(argv[0]);
         return EXIT_FAILURE;
@@ -102,52 +250,8 @@ int main(int argc, char** argv) {
         return EXIT_FAILURE;
     }
 
-    const std::string circuit_file = circuitFileName(circuit_arg);
-    const std::string circuit_path = "testcases/" + circuit_file;
-    const std::string output_path = "testcases/" + circuitBaseName(circuit_file) + ".in";
-
     try {
-        auto circuit = io::parseCircuit(circuit_path);
-        core::PatternGenerator generator(circuit, seed);
-        auto patterns = generator.generate(pattern_count);
-        core::Simulator simulator(circuit);
-
-        std::ofstream output(output_path);
-        if (!output) {
-            throw std::runtime_error("Failed to open output file for writing: " + output_path);
-        }
-        const auto& outputs = circuit.primaryOutputs();
-        std::vector<io::PatternRow> rows;
-        rows.reserve(patterns.size());
-
-        for (std::size_t i = 0; i < patterns.size(); ++i) {
-            output << patterns[i].toString(circuit) << " | ";
-            io::PatternRow row;
-            row.pattern = patterns[i];
-            const auto golden_outputs = simulator.simulate(patterns[i]).primary_outputs;
-            for (std::size_t j = 0; j < outputs.size(); ++j) {
-                const std::string& net_name = circuit.netName(outputs[j]);
-                output << net_name << '=' << golden_outputs[j];
-                row.provided_outputs[outputs[j]] = golden_outputs[j];
-                if (j + 1 != outputs.size()) {
-                    output << ", ";
-                }
-            }
-            output << '\n';
-            rows.push_back(std::move(row));
-        }
-        std::cout << "Wrote " << patterns.size() << " patterns for " << circuit_file << " to "
-                  << output_path << '\n';
-
-        algorithm::BitParallelSimulator bit(circuit, rows);
-        bit.start();
-
-        const std::string ans_path = "testcases/" + circuitBaseName(circuit_file) + ".ans";
-        io::writeAnswerFile(bit, ans_path);
-        std::cout << "Wrote fault answers to " << ans_path << '\n';
-        const std::string sha_path = ans_path + ".sha";
-        writeShaFile(ans_path, sha_path);
-        std::cout << "Wrote SHA digest to " << sha_path << '\n';
+        generatePatterns(circuitFileName(circuit_arg), pattern_count, seed, true);
     } catch (const std::exception& ex) {
         std::cerr << "Error: " << ex.what() << '\n';
         return EXIT_FAILURE;
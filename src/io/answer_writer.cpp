@@ -1,37 +1,153 @@
 #include "io/answer_writer.hpp"
 
+#include <filesystem>
 #include <fstream>
+#include <ostream>
 #include <stdexcept>
 
-namespace io {
+#include "io/sha256.hpp"
 
-void writeAnswerFile(const algorithm::FaultSimulator& simulator, const std::string& output_path) {
-    const auto& nets = simulator.netNames();
+namespace {
 
-    std::ofstream output(output_path, std::ios::binary);
-    if (!output) {
-        throw std::runtime_error("Unable to open output file: " + output_path);
-    }
-
-    output << "# pattern_index net stuck_at_0_eq stuck_at_1_eq\n";
+void writeAnswerLines(const algorithm::FaultSimulator& simulator, std::ostream& output,
+                      std::size_t first_pattern_index,
+                      const std::vector<std::size_t>& source_row) {
+    const auto& nets = simulator.netNames();
+    const auto& net_order = simulator.answerNetOrder();
 
-    const std::size_t pattern_count = simulator.patternCount();
+    const std::size_t pattern_count =
+        source_row.empty() ? simulator.patternCount() : source_row.size();
+    std::string line_buffer;
     for (std::size_t i = 0; i < pattern_count; ++i) {
-        if (!simulator.answers.has(i)) {
+        const std::size_t row = source_row.empty() ? i : source_row[i];
+        if (!simulator.answers.has(row)) {
             throw std::runtime_error("Answer table missing data for pattern " + std::to_string(i));
         }
-        const auto& fault_results_raw = simulator.answers.get(i);
-        std::vector<algorithm::FaultEvaluation> fault_results = fault_results_raw;
+        const auto& fault_results = simulator.answers.get(row);
         if (fault_results.size() < nets.size()) {
             throw std::runtime_error("Answer size mismatch for pattern " + std::to_string(i));
         }
 
-        for (std::size_t net_id = 0; net_id < nets.size(); ++net_id) {
-            output << i << ' ' << nets[net_id] << ' '
-                   << (fault_results[net_id].stuck0_eq ? 1 : 0) << ' '
-                   << (fault_results[net_id].stuck1_eq ? 1 : 0) << '\n';
+        // Lines are formatted into one buffer per pattern; the stream sees a single write.
+        const std::string prefix = std::to_string(first_pattern_index + i) + ' ';
+        line_buffer.clear();
+        for (const core::NetId net_id : net_order) {
+            const auto& result = fault_results[net_id];
+            line_buffer += prefix;
+            line_buffer += nets[net_id];
+            line_buffer += ' ';
+            line_buffer += result.stuck0_potential ? 'X' : (result.stuck0_eq ? '1' : '0');
+            line_buffer += ' ';
+            line_buffer += result.stuck1_potential ? 'X' : (result.stuck1_eq ? '1' : '0');
+            line_buffer += '\n';
+        }
+        output.write(line_buffer.data(), static_cast<std::streamsize>(line_buffer.size()));
+    }
+}
+
+// Reads the final non-empty line without scanning the whole (possibly huge) file.
+std::string lastLine(std::ifstream& input) {
+    input.seekg(0, std::ios::end);
+    std::streamoff pos = input.tellg();
+    std::string line;
+    while (pos > 0) {
+        input.seekg(--pos);
+        const char ch = static_cast<char>(input.get());
+        if (ch == '\n') {
+            if (!line.empty()) {
+                break;
+            }
+            continue;
+        }
+        line.insert(line.begin(), ch);
+    }
+    return line;
+}
+
+void checkPreviousAnswers(const std::string& path, const std::string& expected_header,
+                          std::size_t pattern_count) {
+    std::ifstream input(path, std::ios::binary);
+    if (!input) {
+        throw std::runtime_error("Unable to open previous answer file: " + path);
+    }
+    std::string header;
+    if (!std::getline(input, header) || header != expected_header) {
+        throw std::runtime_error("Previous answer file is missing the .ans header: " + path);
+    }
+
+    const std::string last = lastLine(input);
+    if (pattern_count == 0) {
+        if (last != header) {
+            throw std::runtime_error("Previous answer file covers patterns, expected none: " + path);
+        }
+        return;
+    }
+    const auto space = last.find(' ');
+    const std::string last_index = last.substr(0, space);
+    if (space == std::string::npos || last_index != std::to_string(pattern_count - 1)) {
+        throw std::runtime_error("Previous answer file does not end at pattern " +
+                                 std::to_string(pattern_count - 1) + ": " + path);
+    }
+}
+
+}  // namespace
+
+namespace io {
+
+void writeAnswerFile(const algorithm::FaultSimulator& simulator, const std::string& output_path,
+                     const std::vector<std::size_t>& source_row, std::string* sha256) {
+    std::ofstream output(output_path, std::ios::binary);
+    if (!output) {
+        throw std::runtime_error("Unable to open output file: " + output_path);
+    }
+
+    if (!sha256) {
+        output << simulator.answerHeader() << '\n';
+        writeAnswerLines(simulator, output, 0, source_row);
+        return;
+    }
+    Sha256 hash;
+    {
+        Sha256Buf buffer(hash, output.rdbuf());
+        std::ostream hashed(&buffer);
+        hashed << simulator.answerHeader() << '\n';
+        writeAnswerLines(simulator, hashed, 0, source_row);
+        if (!hashed.flush()) {
+            throw std::runtime_error("Failed to write output file: " + output_path);
         }
     }
+    *sha256 = hash.hexDigest();
+}
+
+std::string answerSha256(const algorithm::FaultSimulator& simulator,
+                         const std::vector<std::size_t>& source_row) {
+    Sha256 hash;
+    {
+        Sha256Buf buffer(hash);
+        std::ostream hashed(&buffer);
+        hashed << simulator.answerHeader() << '\n';
+        writeAnswerLines(simulator, hashed, 0, source_row);
+    }
+    return hash.hexDigest();
+}
+
+void appendAnswerFile(const algorithm::FaultSimulator& simulator,
+                      const std::string& previous_path,
+                      std::size_t first_pattern_index,
+                      const std::string& output_path,
+                      const std::vector<std::size_t>& source_row) {
+    checkPreviousAnswers(previous_path, simulator.answerHeader(), first_pattern_index);
+
+    namespace fs = std::filesystem;
+    if (!fs::exists(output_path) || !fs::equivalent(previous_path, output_path)) {
+        fs::copy_file(previous_path, output_path, fs::copy_options::overwrite_existing);
+    }
+
+    std::ofstream output(output_path, std::ios::binary | std::ios::app);
+    if (!output) {
+        throw std::runtime_error("Unable to open output file: " + output_path);
+    }
+    writeAnswerLines(simulator, output, first_pattern_index, source_row);
 }
 
 }  // namespace io
@@ -9,6 +9,24 @@
 
 namespace io {
 
-void writeAnswerFile(const algorithm::FaultSimulator& simulator, const std::string& output_path);
+// `source_row[i]` names the simulator row whose answers are written for pattern i, letting
+// duplicate patterns share one simulated row; empty means row i for pattern i. When `sha256`
+// is given it receives the hex digest of the bytes written, hashed as they are produced.
+void writeAnswerFile(const algorithm::FaultSimulator& simulator, const std::string& output_path,
+                     const std::vector<std::size_t>& source_row = {},
+                     std::string* sha256 = nullptr);
+
+// SHA-256 of the .ans that writeAnswerFile would produce, without writing it anywhere.
+std::string answerSha256(const algorithm::FaultSimulator& simulator,
+                         const std::vector<std::size_t>& source_row = {});
+
+// Extends a previous .ans covering `first_pattern_index` patterns with the simulator's rows,
+// numbered from `first_pattern_index`. The previous file is copied to `output_path` first
+// unless both paths name the same file, in which case it is appended in place.
+void appendAnswerFile(const algorithm::FaultSimulator& simulator,
+                      const std::string& previous_path,
+                      std::size_t first_pattern_index,
+                      const std::string& output_path,
+                      const std::vector<std::size_t>& source_row = {});
 
 }  // namespace io
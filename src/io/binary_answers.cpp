@@ -0,0 +1,270 @@
+#include "io/binary_answers.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr char kMagic[8] = {'F', 'S', 'I', 'M', 'A', 'N', 'B', '1'};
+constexpr std::size_t kHeaderWords = 5;
+const char* const kAnswerHeader = "# pattern_index net stuck_at_0_eq stuck_at_1_eq";
+
+std::uint64_t tailMask(std::size_t pattern_count, std::size_t word) {
+    const std::size_t remaining = pattern_count - word * 64;
+    return remaining >= 64 ? ~std::uint64_t{0} : (std::uint64_t{1} << remaining) - 1;
+}
+
+void writeWords(std::ostream& output, const std::uint64_t* words, std::size_t count) {
+    output.write(reinterpret_cast<const char*>(words),
+                 static_cast<std::streamsize>(count * sizeof(std::uint64_t)));
+}
+
+}  // namespace
+
+namespace io {
+
+void writeBinaryAnswerFile(const algorithm::FaultSimulator& simulator,
+                           const std::string& output_path,
+                           const std::vector<std::size_t>& source_row) {
+    std::ofstream output(output_path, std::ios::binary);
+    if (!output) {
+        throw std::runtime_error("Unable to open output file: " + output_path);
+    }
+    writeBinaryAnswers(simulator, output, source_row);
+    if (!output) {
+        throw std::runtime_error("Failed to write output file: " + output_path);
+    }
+}
+
+void writeBinaryAnswers(const algorithm::FaultSimulator& simulator, std::ostream& output,
+                        const std::vector<std::size_t>& source_row) {
+    const auto& names = simulator.netNames();
+    const auto& net_order = simulator.answerNetOrder();
+    const std::size_t pattern_count =
+        source_row.empty() ? simulator.patternCount() : source_row.size();
+    const std::size_t words = (pattern_count + 63) / 64;
+    const std::size_t sections = net_order.size() * 2;
+
+    // sections x words, section 2k is SA0 of the k-th net in .ans order and 2k+1 its SA1.
+    std::vector<std::uint64_t> bits(sections * words, 0);
+    for (std::size_t p = 0; p < pattern_count; ++p) {
+        const std::size_t row = source_row.empty() ? p : source_row[p];
+        if (!simulator.answers.has(row)) {
+            throw std::runtime_error("Answer table missing data for pattern " + std::to_string(p));
+        }
+        const auto& fault_results = simulator.answers.get(row);
+        if (fault_results.size() < names.size()) {
+            throw std::runtime_error("Answer size mismatch for pattern " + std::to_string(p));
+        }
+        const std::size_t word = p / 64;
+        const std::uint64_t bit = std::uint64_t{1} << (p % 64);
+        for (std::size_t k = 0; k < net_order.size(); ++k) {
+            const auto& result = fault_results[net_order[k]];
+            if (result.stuck0_potential || result.stuck1_potential) {
+                throw std::runtime_error(
+                    ".ansb cannot store potentially-detected faults; write .ans text instead");
+            }
+            if (result.stuck0_eq) {
+                bits[(2 * k) * words + word] |= bit;
+            }
+            if (result.stuck1_eq) {
+                bits[(2 * k + 1) * words + word] |= bit;
+            }
+        }
+    }
+
+    std::vector<std::uint64_t> offsets(sections + 1, 0);
+    for (std::size_t s = 0; s < sections; ++s) {
+        std::size_t exceptions = 0;
+        for (std::size_t w = 0; w < words; ++w) {
+            exceptions += bits[s * words + w] != tailMask(pattern_count, w);
+        }
+        offsets[s + 1] = offsets[s] + 2 * exceptions;
+    }
+    const bool sparse = offsets.size() + offsets.back() < bits.size();
+    const auto encoding = sparse ? BinaryAnswerEncoding::Sparse : BinaryAnswerEncoding::Dense;
+
+    const std::uint64_t header[] = {pattern_count, net_order.size(), words,
+                                    static_cast<std::uint64_t>(encoding)};
+    output.write(kMagic, sizeof(kMagic));
+    writeWords(output, header, 4);
+    for (const core::NetId net_id : net_order) {
+        const std::string& name = names[net_id];
+        const std::uint64_t length = name.size();
+        writeWords(output, &length, 1);
+        output.write(name.data(), static_cast<std::streamsize>(name.size()));
+        const char padding[8] = {};
+        output.write(padding, static_cast<std::streamsize>((8 - name.size() % 8) % 8));
+    }
+
+    if (!sparse) {
+        writeWords(output, bits.data(), bits.size());
+    } else {
+        writeWords(output, offsets.data(), offsets.size());
+        for (std::size_t s = 0; s < sections; ++s) {
+            for (std::size_t w = 0; w < words; ++w) {
+                const std::uint64_t value = bits[s * words + w];
+                if (value != tailMask(pattern_count, w)) {
+                    const std::uint64_t pair[] = {w, value};
+                    writeWords(output, pair, 2);
+                }
+            }
+        }
+    }
+}
+
+BinaryAnswerFile::BinaryAnswerFile(const std::string& path) {
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Unable to open binary answer file: " + path);
+    }
+    struct stat info {};
+    if (::fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(kHeaderWords * 8)) {
+        ::close(fd);
+        throw std::runtime_error("Not an .ansb file: " + path);
+    }
+    const std::size_t size_bytes = static_cast<std::size_t>(info.st_size);
+    void* mapped = ::mmap(nullptr, size_bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        throw std::runtime_error("Unable to map binary answer file: " + path);
+    }
+    data_ = static_cast<const std::uint64_t*>(mapped);
+    size_words_ = size_bytes / sizeof(std::uint64_t);
+
+    auto fail = [&](const std::string& reason) {
+        ::munmap(const_cast<std::uint64_t*>(data_), size_words_ * sizeof(std::uint64_t));
+        throw std::runtime_error(reason + ": " + path);
+    };
+    if (std::memcmp(data_, kMagic, sizeof(kMagic)) != 0) {
+        fail("Not an .ansb file");
+    }
+    pattern_count_ = static_cast<std::size_t>(data_[1]);
+    const std::uint64_t net_count = data_[2];
+    word_count_ = static_cast<std::size_t>(data_[3]);
+    if (word_count_ != (pattern_count_ + 63) / 64 || net_count > size_words_ ||
+        data_[4] > static_cast<std::uint64_t>(BinaryAnswerEncoding::Sparse)) {
+        fail("Corrupt .ansb header");
+    }
+    encoding_ = static_cast<BinaryAnswerEncoding>(data_[4]);
+
+    std::size_t pos = kHeaderWords;
+    names_.reserve(static_cast<std::size_t>(net_count));
+    for (std::uint64_t k = 0; k < net_count; ++k) {
+        if (pos >= size_words_ || data_[pos] > (size_words_ - pos - 1) * 8) {
+            fail("Truncated .ansb net names");
+        }
+        const std::size_t length = static_cast<std::size_t>(data_[pos++]);
+        names_.emplace_back(reinterpret_cast<const char*>(data_ + pos), length);
+        pos += (length + 7) / 8;
+    }
+
+    const std::size_t sections = names_.size() * 2;
+    if (encoding_ == BinaryAnswerEncoding::Dense) {
+        if (word_count_ != 0 && sections > (size_words_ - pos) / word_count_) {
+            fail("Truncated .ansb matrix");
+        }
+        body_ = data_ + pos;
+        return;
+    }
+    if (sections + 1 > size_words_ - pos) {
+        fail("Truncated .ansb section table");
+    }
+    section_offsets_ = data_ + pos;
+    body_ = section_offsets_ + sections + 1;
+    const std::size_t body_words = size_words_ - (pos + sections + 1);
+    for (std::size_t s = 0; s < sections; ++s) {
+        const std::uint64_t begin = section_offsets_[s];
+        const std::uint64_t end = section_offsets_[s + 1];
+        if (begin > end || end > body_words || (end - begin) % 2 != 0) {
+            fail("Corrupt .ansb section table");
+        }
+    }
+}
+
+BinaryAnswerFile::~BinaryAnswerFile() {
+    ::munmap(const_cast<std::uint64_t*>(data_), size_words_ * sizeof(std::uint64_t));
+}
+
+std::uint64_t BinaryAnswerFile::fullWord(std::size_t word) const {
+    return tailMask(pattern_count_, word);
+}
+
+std::uint64_t BinaryAnswerFile::stuckWord(std::size_t net, bool stuck_at_0,
+                                          std::size_t word) const {
+    const std::size_t section = net * 2 + (stuck_at_0 ? 0 : 1);
+    if (encoding_ == BinaryAnswerEncoding::Dense) {
+        return body_[section * word_count_ + word];
+    }
+    // Pairs are sorted by word index.
+    std::size_t lo = static_cast<std::size_t>(section_offsets_[section]) / 2;
+    std::size_t hi = static_cast<std::size_t>(section_offsets_[section + 1]) / 2;
+    while (lo < hi) {
+        const std::size_t mid = lo + (hi - lo) / 2;
+        const std::uint64_t index = body_[mid * 2];
+        if (index == word) {
+            return body_[mid * 2 + 1];
+        }
+        if (index < word) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return fullWord(word);
+}
+
+void convertBinaryAnswersToText(const std::string& binary_path, const std::string& output_path) {
+    const BinaryAnswerFile answers(binary_path);
+    std::ofstream output(output_path, std::ios::binary);
+    if (!output) {
+        throw std::runtime_error("Unable to open output file: " + output_path);
+    }
+
+    std::string buffer;
+    buffer.reserve(1 << 20);
+    buffer += kAnswerHeader;
+    buffer += '\n';
+
+    const std::size_t net_count = answers.netCount();
+    std::vector<std::uint64_t> stuck0(net_count);
+    std::vector<std::uint64_t> stuck1(net_count);
+    char index_text[24];
+    for (std::size_t w = 0; w < answers.wordCount(); ++w) {
+        for (std::size_t k = 0; k < net_count; ++k) {
+            stuck0[k] = answers.stuckWord(k, true, w);
+            stuck1[k] = answers.stuckWord(k, false, w);
+        }
+        const std::size_t lanes = std::min<std::size_t>(64, answers.patternCount() - w * 64);
+        for (std::size_t lane = 0; lane < lanes; ++lane) {
+            const auto index_end =
+                std::to_chars(index_text, index_text + sizeof(index_text), w * 64 + lane).ptr;
+            for (std::size_t k = 0; k < net_count; ++k) {
+                buffer.append(index_text, index_end);
+                buffer += ' ';
+                buffer += answers.netName(k);
+                buffer += ((stuck0[k] >> lane) & 1U) ? " 1 " : " 0 ";
+                buffer += ((stuck1[k] >> lane) & 1U) ? '1' : '0';
+                buffer += '\n';
+            }
+            if (buffer.size() >= (1 << 20)) {
+                output.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+                buffer.clear();
+            }
+        }
+    }
+    output.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    if (!output) {
+        throw std::runtime_error("Failed to write output file: " + output_path);
+    }
+}
+
+}  // namespace io
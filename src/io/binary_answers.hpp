@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "algorithm/fault_simulator.hpp"
+
+namespace io {
+
+// .ansb layout (native 64-bit words):
+//   "FSIMANB1", pattern_count, net_count, word_count, encoding
+//   net_count names in .ans order, each a length word followed by bytes padded to 8
+//   Dense:  per net, word_count SA0-equal words then word_count SA1-equal words
+//   Sparse: net_count * 2 + 1 section offsets, then per (net, SA0/SA1) section the
+//           (word index, word) pairs of every word that is not all-equal
+// Bit p % 64 of word p / 64 is pattern p; bits past pattern_count are zero.
+enum class BinaryAnswerEncoding : std::uint64_t { Dense = 0, Sparse = 1 };
+
+// Writes the answers as .ansb, choosing whichever encoding is smaller. `source_row` is
+// interpreted as in writeAnswerFile.
+void writeBinaryAnswerFile(const algorithm::FaultSimulator& simulator,
+                           const std::string& output_path,
+                           const std::vector<std::size_t>& source_row = {});
+void writeBinaryAnswers(const algorithm::FaultSimulator& simulator, std::ostream& output,
+                        const std::vector<std::size_t>& source_row = {});
+
+// Read-only view of an .ansb file mapped into memory.
+class BinaryAnswerFile {
+public:
+    explicit BinaryAnswerFile(const std::string& path);
+    ~BinaryAnswerFile();
+    BinaryAnswerFile(const BinaryAnswerFile&) = delete;
+    BinaryAnswerFile& operator=(const BinaryAnswerFile&) = delete;
+
+    std::size_t patternCount() const { return pattern_count_; }
+    std::size_t netCount() const { return names_.size(); }
+    std::size_t wordCount() const { return word_count_; }
+    BinaryAnswerEncoding encoding() const { return encoding_; }
+    // Nets are indexed in .ans order.
+    std::string_view netName(std::size_t net) const { return names_[net]; }
+
+    // Equality bits of patterns 64 * word .. 64 * word + 63 for one net.
+    std::uint64_t stuckWord(std::size_t net, bool stuck_at_0, std::size_t word) const;
+
+private:
+    const std::uint64_t* data_{nullptr};
+    std::size_t size_words_{0};
+    std::size_t pattern_count_{0};
+    std::size_t word_count_{0};
+    BinaryAnswerEncoding encoding_{BinaryAnswerEncoding::Dense};
+    std::vector<std::string_view> names_;
+    const std::uint64_t* body_{nullptr};
+    const std::uint64_t* section_offsets_{nullptr};
+
+    std::uint64_t fullWord(std::size_t word) const;
+};
+
+// Streams an .ansb back to canonical .ans text, byte-identical to writeAnswerFile.
+void convertBinaryAnswersToText(const std::string& binary_path, const std::string& output_path);
+
+}  // namespace io
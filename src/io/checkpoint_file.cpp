@@ -0,0 +1,219 @@
+#include "io/checkpoint_file.hpp"
+
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+
+namespace {
+
+constexpr char kMagic[8] = {'F', 'S', 'I', 'M', 'C', 'K', 'P', '1'};
+constexpr std::uint64_t kFnvOffset = 1469598103934665603ULL;
+constexpr std::uint64_t kFnvPrime = 1099511628211ULL;
+constexpr std::uint64_t kHeaderBytes = sizeof(kMagic) + 4 * sizeof(std::uint64_t);
+
+class Fnv1a {
+public:
+    void add(const void* data, std::size_t size) {
+        const auto* bytes = static_cast<const unsigned char*>(data);
+        for (std::size_t i = 0; i < size; ++i) {
+            state_ ^= bytes[i];
+            state_ *= kFnvPrime;
+        }
+    }
+    void add(std::uint64_t value) { add(&value, sizeof(value)); }
+    void add(const std::string& text) {
+        add(static_cast<std::uint64_t>(text.size()));
+        add(text.data(), text.size());
+    }
+    std::uint64_t value() const { return state_; }
+
+private:
+    std::uint64_t state_{kFnvOffset};
+};
+
+std::size_t wordsPerPattern(std::size_t net_count) {
+    return (net_count * 2 + 63) / 64;
+}
+
+std::uint64_t recordChecksum(const std::vector<std::uint64_t>& words) {
+    Fnv1a hash;
+    hash.add(words.data(), words.size() * sizeof(std::uint64_t));
+    return hash.value();
+}
+
+void writeHeader(std::ofstream& output, const io::CheckpointHeader& header) {
+    const std::uint64_t fields[] = {header.circuit_hash, header.pattern_hash, header.net_count,
+                                    header.pattern_count};
+    output.write(kMagic, sizeof(kMagic));
+    output.write(reinterpret_cast<const char*>(fields), sizeof(fields));
+}
+
+}  // namespace
+
+namespace io {
+
+std::uint64_t hashCircuit(const core::Circuit& circuit) {
+    Fnv1a hash;
+    hash.add(circuit.name());
+    hash.add(static_cast<std::uint64_t>(circuit.netCount()));
+    for (const auto& name : circuit.netNames()) {
+        hash.add(name);
+    }
+    for (const auto& gate : circuit.gates()) {
+        hash.add(static_cast<std::uint64_t>(gate.type));
+        hash.add(static_cast<std::uint64_t>(gate.output));
+        hash.add(static_cast<std::uint64_t>(gate.inputs.size()));
+        for (auto input : gate.inputs) {
+            hash.add(static_cast<std::uint64_t>(input));
+        }
+    }
+    for (auto po : circuit.primaryOutputs()) {
+        hash.add(static_cast<std::uint64_t>(po));
+    }
+    return hash.value();
+}
+
+std::uint64_t hashPatterns(const std::vector<PatternRow>& rows) {
+    Fnv1a hash;
+    hash.add(static_cast<std::uint64_t>(rows.size()));
+    for (const auto& row : rows) {
+        hash.add(static_cast<std::uint64_t>(row.pattern.assignments.size()));
+        for (const auto& entry : row.pattern.assignments) {
+            hash.add(static_cast<std::uint64_t>(entry.net));
+            hash.add(static_cast<std::uint64_t>(entry.value));
+        }
+        // provided_outputs is unordered; combine order-independently.
+        std::uint64_t outputs = 0;
+        for (const auto& kv : row.provided_outputs) {
+            Fnv1a entry;
+            entry.add(static_cast<std::uint64_t>(kv.first));
+            entry.add(static_cast<std::uint64_t>(kv.second));
+            outputs += entry.value();
+        }
+        hash.add(outputs);
+    }
+    return hash.value();
+}
+
+CheckpointState loadCheckpoint(const std::string& path,
+                               const CheckpointHeader& expected,
+                               algorithm::AnswerTable& answers) {
+    std::ifstream input(path, std::ios::binary);
+    if (!input) {
+        throw std::runtime_error("Unable to open checkpoint file: " + path);
+    }
+
+    char magic[sizeof(kMagic)] = {};
+    std::uint64_t fields[4] = {};
+    input.read(magic, sizeof(magic));
+    input.read(reinterpret_cast<char*>(fields), sizeof(fields));
+    if (!input || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0) {
+        throw std::runtime_error("Not a fault simulation checkpoint: " + path);
+    }
+    if (fields[0] != expected.circuit_hash) {
+        throw std::runtime_error("Checkpoint was written for a different circuit: " + path);
+    }
+    if (fields[1] != expected.pattern_hash || fields[3] != expected.pattern_count) {
+        throw std::runtime_error("Checkpoint was written for different patterns: " + path);
+    }
+    if (fields[2] != expected.net_count) {
+        throw std::runtime_error("Checkpoint net count does not match circuit: " + path);
+    }
+
+    const std::size_t net_count = static_cast<std::size_t>(expected.net_count);
+    const std::size_t words = wordsPerPattern(net_count);
+    CheckpointState state;
+    state.valid_bytes = kHeaderBytes;
+
+    std::vector<std::uint64_t> record;
+    std::vector<algorithm::FaultEvaluation> row(net_count);
+    while (true) {
+        std::uint64_t span[2] = {};
+        if (!input.read(reinterpret_cast<char*>(span), sizeof(span))) {
+            break;
+        }
+        const std::uint64_t first = span[0];
+        const std::uint64_t count = span[1];
+        if (first != state.completed_patterns || count == 0 ||
+            count > expected.pattern_count - first) {
+            break;
+        }
+        record.assign(2 + count * words, 0);
+        record[0] = first;
+        record[1] = count;
+        std::uint64_t checksum = 0;
+        if (!input.read(reinterpret_cast<char*>(record.data() + 2),
+                        static_cast<std::streamsize>(count * words * sizeof(std::uint64_t))) ||
+            !input.read(reinterpret_cast<char*>(&checksum), sizeof(checksum)) ||
+            checksum != recordChecksum(record)) {
+            break;
+        }
+
+        for (std::size_t p = 0; p < count; ++p) {
+            const std::uint64_t* bits = record.data() + 2 + p * words;
+            for (std::size_t net = 0; net < net_count; ++net) {
+                const std::size_t bit = net * 2;
+                row[net].stuck0_eq = ((bits[bit / 64] >> (bit % 64)) & 1ULL) != 0;
+                row[net].stuck1_eq = ((bits[(bit + 1) / 64] >> ((bit + 1) % 64)) & 1ULL) != 0;
+            }
+            answers.setRow(first + p, row);
+        }
+        state.completed_patterns += count;
+        state.valid_bytes += record.size() * sizeof(std::uint64_t) + sizeof(checksum);
+    }
+    return state;
+}
+
+CheckpointWriter::CheckpointWriter(const std::string& path, const CheckpointHeader& header)
+    : output_(path, std::ios::binary | std::ios::trunc),
+      net_count_(static_cast<std::size_t>(header.net_count)) {
+    if (!output_) {
+        throw std::runtime_error("Unable to open checkpoint file: " + path);
+    }
+    writeHeader(output_, header);
+    output_.flush();
+}
+
+CheckpointWriter::CheckpointWriter(const std::string& path, const CheckpointHeader& header,
+                                   std::uint64_t valid_bytes)
+    : net_count_(static_cast<std::size_t>(header.net_count)) {
+    std::filesystem::resize_file(path, valid_bytes);
+    output_.open(path, std::ios::binary | std::ios::app);
+    if (!output_) {
+        throw std::runtime_error("Unable to open checkpoint file: " + path);
+    }
+}
+
+void CheckpointWriter::appendChunk(const algorithm::AnswerTable& answers,
+                                   std::size_t first_pattern, std::size_t count) {
+    const std::size_t words = wordsPerPattern(net_count_);
+    record_.assign(2 + count * words, 0);
+    record_[0] = first_pattern;
+    record_[1] = count;
+    for (std::size_t p = 0; p < count; ++p) {
+        const auto& row = answers.get(first_pattern + p);
+        std::uint64_t* bits = record_.data() + 2 + p * words;
+        for (std::size_t net = 0; net < net_count_; ++net) {
+            if (row[net].stuck0_potential || row[net].stuck1_potential) {
+                throw std::runtime_error("Checkpoints cannot store potentially-detected faults");
+            }
+            const std::size_t bit = net * 2;
+            if (row[net].stuck0_eq) {
+                bits[bit / 64] |= 1ULL << (bit % 64);
+            }
+            if (row[net].stuck1_eq) {
+                bits[(bit + 1) / 64] |= 1ULL << ((bit + 1) % 64);
+            }
+        }
+    }
+    const std::uint64_t checksum = recordChecksum(record_);
+    output_.write(reinterpret_cast<const char*>(record_.data()),
+                  static_cast<std::streamsize>(record_.size() * sizeof(std::uint64_t)));
+    output_.write(reinterpret_cast<const char*>(&checksum), sizeof(checksum));
+    output_.flush();
+    if (!output_) {
+        throw std::runtime_error("Failed to write checkpoint record");
+    }
+}
+
+}  // namespace io
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "algorithm/fault_simulator.hpp"
+#include "core/circuit.hpp"
+#include "io/pattern_loader.hpp"
+
+namespace io {
+
+// Identifies the run a checkpoint belongs to; resuming requires every field to match.
+struct CheckpointHeader {
+    std::uint64_t circuit_hash{0};
+    std::uint64_t pattern_hash{0};
+    std::uint64_t net_count{0};
+    std::uint64_t pattern_count{0};
+};
+
+// Structural hashes (net names/ids, gates; pattern values and provided outputs), so a
+// checkpoint is only reused for the same netlist numbering and the same pattern rows.
+std::uint64_t hashCircuit(const core::Circuit& circuit);
+std::uint64_t hashPatterns(const std::vector<PatternRow>& rows);
+
+struct CheckpointState {
+    std::size_t completed_patterns{0};
+    std::uint64_t valid_bytes{0};
+};
+
+// Loads the contiguous prefix of intact chunk records into `answers` (which must already be
+// sized for the full run). A record torn by a crash ends the prefix.
+CheckpointState loadCheckpoint(const std::string& path,
+                               const CheckpointHeader& expected,
+                               algorithm::AnswerTable& answers);
+
+// Append-only checkpoint file: a header followed by one record per finished chunk. A record
+// stores the SA0/SA1 equality bits of each pattern packed two per net (by net id) and ends
+// with a checksum.
+class CheckpointWriter {
+public:
+    // Starts a new file, discarding any previous contents.
+    CheckpointWriter(const std::string& path, const CheckpointHeader& header);
+    // Continues an existing checkpoint, dropping anything after `valid_bytes`.
+    CheckpointWriter(const std::string& path, const CheckpointHeader& header,
+                     std::uint64_t valid_bytes);
+
+    void appendChunk(const algorithm::AnswerTable& answers, std::size_t first_pattern,
+                     std::size_t count);
+
+private:
+    std::ofstream output_;
+    std::size_t net_count_{0};
+    std::vector<std::uint64_t> record_;
+};
+
+}  // namespace io
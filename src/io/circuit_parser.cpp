@@ -1,167 +1,331 @@
 #include "io/circuit_parser.hpp"
 
-#include <algorithm>
-#include <cctype>
-#include <fstream>
-#include <sstream>
+#include <cstdint>
+#include <functional>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 namespace {
 
-std::string trim(const std::string& text) {
-    std::size_t start = 0;
-    while (start < text.size() && std::isspace(static_cast<unsigned char>(text[start]))) {
-        ++start;
+// Read-only view of a whole file; net names are interned as views into it, so it has to
+// outlive parsing.
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path) {
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("Unable to open circuit file: " + path);
+        }
+        struct stat info {};
+        if (::fstat(fd, &info) != 0) {
+            ::close(fd);
+            throw std::runtime_error("Unable to stat circuit file: " + path);
+        }
+        size_ = static_cast<std::size_t>(info.st_size);
+        if (size_ > 0) {
+            void* mapped = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped == MAP_FAILED) {
+                ::close(fd);
+                throw std::runtime_error("Unable to map circuit file: " + path);
+            }
+            ::madvise(mapped, size_, MADV_SEQUENTIAL);
+            data_ = static_cast<const char*>(mapped);
+        }
+        ::close(fd);
     }
-    std::size_t end = text.size();
-    while (end > start && std::isspace(static_cast<unsigned char>(text[end - 1]))) {
-        --end;
+    ~MappedFile() {
+        if (data_ != nullptr) {
+            ::munmap(const_cast<char*>(data_), size_);
+        }
     }
-    return text.substr(start, end - start);
-}
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
 
-std::string toLower(std::string value) {
-    std::transform(value.begin(), value.end(), value.begin(),
-                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
-    return value;
-}
+    const char* begin() const { return data_; }
+    const char* end() const { return data_ + size_; }
+
+private:
+    const char* data_{nullptr};
+    std::size_t size_{0};
+};
 
-void stripTrailingSemicolon(std::string& text) {
-    if (!text.empty() && text.back() == ';') {
-        text.pop_back();
+// Hands out dense net ids in first-seen order, keeping the name table and net types the way
+// core::Circuit::ensureNet() would: a net first seen as a wire is upgraded when it is later
+// declared as a port. Open addressing over ids, keyed by the views into the mapped file.
+class NetInterner {
+public:
+    NetInterner() : slots_(1024, 0) {}
+
+    core::NetId intern(std::string_view name, core::NetType type) {
+        std::size_t slot = std::hash<std::string_view>{}(name) & (slots_.size() - 1);
+        while (slots_[slot] != 0) {
+            const core::NetId id = slots_[slot] - 1;
+            if (names[id] == name) {
+                if (types[id] == core::NetType::Wire && type != core::NetType::Wire) {
+                    types[id] = type;
+                }
+                return id;
+            }
+            slot = (slot + 1) & (slots_.size() - 1);
+        }
+        const core::NetId id = names.size();
+        names.push_back(name);
+        types.push_back(type);
+        declared.push_back(0);
+        slots_[slot] = id + 1;
+        if (names.size() * 2 > slots_.size()) {
+            rehash();
+        }
+        return id;
     }
-}
 
-std::vector<std::string> splitCommaSeparated(const std::string& payload) {
-    std::vector<std::string> tokens;
-    std::string token;
-    std::stringstream ss(payload);
-    while (std::getline(ss, token, ',')) {
-        token = trim(token);
-        if (!token.empty()) {
-            tokens.push_back(token);
+    std::vector<std::string_view> names;
+    std::vector<core::NetType> types;
+    // Bit set of the port lists (kInputList, ...) a net already appears in.
+    std::vector<std::uint8_t> declared;
+
+private:
+    void rehash() {
+        std::vector<core::NetId> grown(slots_.size() * 2, 0);
+        for (core::NetId id = 0; id < names.size(); ++id) {
+            std::size_t slot = std::hash<std::string_view>{}(names[id]) & (grown.size() - 1);
+            while (grown[slot] != 0) {
+                slot = (slot + 1) & (grown.size() - 1);
+            }
+            grown[slot] = id + 1;
         }
+        slots_ = std::move(grown);
     }
-    return tokens;
-}
 
-}  // namespace
+    std::vector<core::NetId> slots_;
+};
 
-namespace io {
+constexpr std::uint8_t kInputList = 1;
+constexpr std::uint8_t kOutputList = 2;
+constexpr std::uint8_t kWireList = 4;
 
-core::Circuit parseCircuit(const std::string& file_path) {
-    std::ifstream input(file_path);
-    if (!input) {
-        throw std::runtime_error("Unable to open circuit file: " + file_path);
-    }
+bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+}
 
-    core::Circuit circuit;
-    std::string pending_statement;
-    std::string line;
-    while (std::getline(input, line)) {
-        const auto comment_pos = line.find("//");
-        if (comment_pos != std::string::npos) {
-            line = line.substr(0, comment_pos);
-        }
-        line = trim(line);
-        if (line.empty()) {
-            continue;
+bool isPunctuation(char c) {
+    return c == ',' || c == ';' || c == '(' || c == ')';
+}
+
+// Case-insensitive match against a lower-case keyword.
+bool isKeyword(std::string_view word, std::string_view keyword) {
+    if (word.size() != keyword.size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < word.size(); ++i) {
+        const char c = word[i] >= 'A' && word[i] <= 'Z' ? static_cast<char>(word[i] - 'A' + 'a')
+                                                        : word[i];
+        if (c != keyword[i]) {
+            return false;
         }
+    }
+    return true;
+}
 
-        std::string lower = toLower(line);
-        if (lower == "endmodule") {
-            break;
+// Tokens of a structural netlist: identifiers (escaped ones run to the next whitespace) and
+// the punctuation , ; ( ). Whitespace and // and /* */ comments are skipped.
+class Lexer {
+public:
+    Lexer(const char* begin, const char* end, const std::string& path)
+        : pos_(begin), end_(end), path_(path) {}
+
+    bool atEnd() {
+        skipSpace();
+        return pos_ == end_;
+    }
+
+    std::string_view identifier() {
+        skipSpace();
+        const char* start = pos_;
+        if (pos_ != end_ && *pos_ == '\\') {
+            while (pos_ != end_ && !isSpace(*pos_)) {
+                ++pos_;
+            }
+        } else {
+            while (pos_ != end_ && !isSpace(*pos_) && !isPunctuation(*pos_) && *pos_ != '/') {
+                ++pos_;
+            }
         }
+        return std::string_view(start, static_cast<std::size_t>(pos_ - start));
+    }
 
-        pending_statement += (pending_statement.empty() ? "" : " ") + line;
-        if (line.find(';') == std::string::npos) {
-            continue;
+    bool accept(char c) {
+        skipSpace();
+        if (pos_ != end_ && *pos_ == c) {
+            ++pos_;
+            return true;
         }
+        return false;
+    }
 
-        std::string statement = pending_statement;
-        pending_statement.clear();
+    [[noreturn]] void fail(const std::string& reason) const {
+        throw std::runtime_error(reason + " at " + path_ + ":" + std::to_string(line_));
+    }
 
-        std::string lowered_statement = toLower(statement);
-        if (lowered_statement.rfind("module", 0) == 0) {
-            std::string declaration = trim(statement.substr(6));
-            stripTrailingSemicolon(declaration);
-            const auto paren_pos = declaration.find('(');
-            if (paren_pos == std::string::npos) {
-                throw std::runtime_error("Malformed module declaration: " + statement);
+    // Identifiers separated by commas up to `close`; empty entries are skipped.
+    template <typename Visit>
+    void list(char close, Visit visit) {
+        bool after_name = false;
+        while (!accept(close)) {
+            if (accept(',')) {
+                after_name = false;
+                continue;
             }
-            std::string module_name = trim(declaration.substr(0, paren_pos));
-            circuit.setName(module_name);
-            continue;
+            if (after_name) {
+                fail("Expected ','");
+            }
+            after_name = true;
+            const std::string_view name = identifier();
+            if (name.empty()) {
+                fail(pos_ == end_ ? "Unterminated statement" : "Unexpected character");
+            }
+            visit(name);
         }
+    }
 
-        if (lowered_statement.rfind("input", 0) == 0) {
-            std::string nets = trim(statement.substr(5));
-            stripTrailingSemicolon(nets);
-            for (const auto& net : splitCommaSeparated(nets)) {
-                circuit.addPrimaryInput(net);
+private:
+    void skipSpace() {
+        while (pos_ != end_) {
+            if (isSpace(*pos_)) {
+                line_ += *pos_ == '\n';
+                ++pos_;
+            } else if (*pos_ == '/' && end_ - pos_ > 1 && pos_[1] == '/') {
+                while (pos_ != end_ && *pos_ != '\n') {
+                    ++pos_;
+                }
+            } else if (*pos_ == '/' && end_ - pos_ > 1 && pos_[1] == '*') {
+                pos_ += 2;
+                while (pos_ != end_ && !(*pos_ == '*' && end_ - pos_ > 1 && pos_[1] == '/')) {
+                    line_ += *pos_ == '\n';
+                    ++pos_;
+                }
+                if (pos_ == end_) {
+                    fail("Unterminated block comment");
+                }
+                pos_ += 2;
+            } else {
+                return;
             }
-            continue;
         }
+    }
 
-        if (lowered_statement.rfind("output", 0) == 0) {
-            std::string nets = trim(statement.substr(6));
-            stripTrailingSemicolon(nets);
-            for (const auto& net : splitCommaSeparated(nets)) {
-                circuit.addPrimaryOutput(net);
-            }
-            continue;
+    const char* pos_;
+    const char* end_;
+    const std::string& path_;
+    std::size_t line_{1};
+};
+
+}  // namespace
+
+namespace io {
+
+core::Circuit parseCircuit(const std::string& file_path, core::NetOrdering ordering) {
+    const MappedFile file(file_path);
+    Lexer lexer(file.begin(), file.end(), file_path);
+
+    std::string module_name;
+    NetInterner nets;
+    std::vector<core::NetId> primary_inputs;
+    std::vector<core::NetId> primary_outputs;
+    std::vector<core::NetId> wires;
+    std::vector<core::Gate> gates;
+
+    // One statement per iteration; everything after endmodule is ignored.
+    while (!lexer.atEnd()) {
+        const std::string_view keyword = lexer.identifier();
+        if (keyword.empty()) {
+            lexer.fail("Unexpected character");
+        }
+        if (isKeyword(keyword, "endmodule")) {
+            break;
         }
 
-        if (lowered_statement.rfind("wire", 0) == 0) {
-            std::string nets = trim(statement.substr(4));
-            stripTrailingSemicolon(nets);
-            for (const auto& net : splitCommaSeparated(nets)) {
-                circuit.addWire(net);
+        if (isKeyword(keyword, "module")) {
+            module_name = lexer.identifier();
+            if (module_name.empty() || !lexer.accept('(')) {
+                lexer.fail("Malformed module declaration");
+            }
+            lexer.list(')', [](std::string_view) {});
+            if (!lexer.accept(';')) {
+                lexer.fail("Malformed module declaration");
             }
             continue;
         }
 
-        // Remaining statements should describe gates.
-        stripTrailingSemicolon(statement);
-        const auto open_paren = statement.find('(');
-        const auto close_paren = statement.rfind(')');
-        if (open_paren == std::string::npos || close_paren == std::string::npos ||
-            close_paren <= open_paren) {
-            throw std::runtime_error("Malformed gate connection block: " + statement);
+        auto declare = [&](core::NetType type, std::uint8_t list_bit,
+                           std::vector<core::NetId>& ids) {
+            lexer.list(';', [&](std::string_view name) {
+                const core::NetId id = nets.intern(name, type);
+                if (!(nets.declared[id] & list_bit)) {
+                    nets.declared[id] |= list_bit;
+                    ids.push_back(id);
+                }
+            });
+        };
+        if (isKeyword(keyword, "input")) {
+            declare(core::NetType::PrimaryInput, kInputList, primary_inputs);
+            continue;
         }
-
-        std::string header = trim(statement.substr(0, open_paren));
-        std::stringstream header_ss(header);
-        std::string gate_type_str;
-        std::string gate_name;
-        if (!(header_ss >> gate_type_str >> gate_name)) {
-            throw std::runtime_error("Unable to parse gate line: " + statement);
+        if (isKeyword(keyword, "output")) {
+            declare(core::NetType::PrimaryOutput, kOutputList, primary_outputs);
+            continue;
         }
-
-        auto connection_payload =
-            statement.substr(open_paren + 1, close_paren - open_paren - 1);
-        auto nets = splitCommaSeparated(connection_payload);
-        if (nets.size() < 2) {
-            throw std::runtime_error("Gate must have an output and at least one input: " +
-                                     statement);
+        if (isKeyword(keyword, "wire")) {
+            declare(core::NetType::Wire, kWireList, wires);
+            continue;
         }
 
+        // Remaining statements are gate instances: <type> <name> (<output>, <inputs>...);
         core::Gate gate;
-        gate.type = core::gateTypeFromString(gate_type_str);
-        gate.name = gate_name;
-        gate.output = circuit.ensureNet(nets.front(), core::NetType::Wire);
-        for (std::size_t i = 1; i < nets.size(); ++i) {
-            gate.inputs.push_back(circuit.ensureNet(nets[i], core::NetType::Wire));
+        gate.type = core::gateTypeFromString(std::string(keyword));
+        gate.name = lexer.identifier();
+        if (gate.name.empty()) {
+            lexer.fail("Unable to parse gate line");
+        }
+        if (!lexer.accept('(')) {
+            lexer.fail("Malformed gate connection block");
         }
-        circuit.addGate(gate);
+        bool has_output = false;
+        lexer.list(')', [&](std::string_view name) {
+            const core::NetId id = nets.intern(name, core::NetType::Wire);
+            if (has_output) {
+                gate.inputs.push_back(id);
+            } else {
+                gate.output = id;
+                has_output = true;
+            }
+        });
+        if (gate.inputs.empty()) {
+            lexer.fail("Gate must have an output and at least one input");
+        }
+        if (!lexer.accept(';')) {
+            lexer.fail("Malformed gate connection block");
+        }
+        gates.push_back(std::move(gate));
     }
 
-    if (circuit.name().empty()) {
+    if (module_name.empty()) {
         throw std::runtime_error("Circuit missing module declaration in " + file_path);
     }
-    circuit.finalizeNets();
+    core::Circuit circuit;
+    circuit.setName(std::move(module_name));
+    circuit.assignNets(std::vector<std::string>(nets.names.begin(), nets.names.end()),
+                       std::move(nets.types), std::move(primary_inputs),
+                       std::move(primary_outputs), std::move(wires), std::move(gates));
+    circuit.finalizeNets(ordering);
     return circuit;
 }
 
@@ -6,6 +6,7 @@
 
 namespace io {
 
-core::Circuit parseCircuit(const std::string& file_path);
+core::Circuit parseCircuit(const std::string& file_path,
+                           core::NetOrdering ordering = core::NetOrdering::ByName);
 
 }  // namespace io
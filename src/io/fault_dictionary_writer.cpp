@@ -0,0 +1,89 @@
+#include "io/fault_dictionary_writer.hpp"
+
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+constexpr char kMagic[8] = {'F', 'S', 'I', 'M', 'D', 'C', 'T', '1'};
+
+void writeWords(std::ostream& output, const std::uint64_t* words, std::size_t count) {
+    output.write(reinterpret_cast<const char*>(words),
+                 static_cast<std::streamsize>(count * sizeof(std::uint64_t)));
+}
+
+}  // namespace
+
+namespace io {
+
+void writeFaultDictionaryFile(const core::Circuit& circuit,
+                              const algorithm::FaultDictionary& dictionary,
+                              const std::string& output_path) {
+    std::ofstream output(output_path, std::ios::binary);
+    if (!output) {
+        throw std::runtime_error("Unable to open output file: " + output_path);
+    }
+    writeFaultDictionary(circuit, dictionary, output);
+    if (!output) {
+        throw std::runtime_error("Failed to write output file: " + output_path);
+    }
+}
+
+void writeFaultDictionary(const core::Circuit& circuit,
+                          const algorithm::FaultDictionary& dictionary, std::ostream& output) {
+    const auto& names = circuit.netNames();
+    const auto& net_order = circuit.netsByName();
+    if (dictionary.fault_count != net_order.size() * 2) {
+        throw std::runtime_error("Fault dictionary does not match circuit nets");
+    }
+    const std::size_t blocks = dictionary.block_count;
+    const std::size_t bitmap_words = (blocks + 63) / 64;
+    const std::size_t sections = net_order.size() * 2;
+
+    // Section 2k is SA0 of the k-th net in .ans order and 2k+1 its SA1, i.e. FaultIds
+    // 2 * net and 2 * net + 1.
+    auto faultOf = [&](std::size_t section) {
+        return static_cast<std::size_t>(net_order[section / 2]) * 2 + section % 2;
+    };
+    std::vector<std::uint64_t> offsets(sections + 1, 0);
+    for (std::size_t s = 0; s < sections; ++s) {
+        const std::uint64_t* fail = &dictionary.fail_words[faultOf(s) * blocks];
+        std::size_t failing = 0;
+        for (std::size_t b = 0; b < blocks; ++b) {
+            failing += fail[b] != 0;
+        }
+        offsets[s + 1] = offsets[s] + bitmap_words + 2 * failing;
+    }
+
+    const std::uint64_t header[] = {dictionary.pattern_count, net_order.size(), blocks,
+                                    bitmap_words};
+    output.write(kMagic, sizeof(kMagic));
+    writeWords(output, header, 4);
+    for (const core::NetId net_id : net_order) {
+        const std::string& name = names[net_id];
+        const std::uint64_t length = name.size();
+        writeWords(output, &length, 1);
+        output.write(name.data(), static_cast<std::streamsize>(name.size()));
+        const char padding[8] = {};
+        output.write(padding, static_cast<std::streamsize>((8 - name.size() % 8) % 8));
+    }
+    writeWords(output, offsets.data(), offsets.size());
+
+    std::vector<std::uint64_t> section;
+    for (std::size_t s = 0; s < sections; ++s) {
+        const std::size_t base = faultOf(s) * blocks;
+        section.assign(bitmap_words, 0);
+        for (std::size_t b = 0; b < blocks; ++b) {
+            const std::uint64_t fail = dictionary.fail_words[base + b];
+            if (fail != 0) {
+                section[b / 64] |= std::uint64_t{1} << (b % 64);
+                section.push_back(fail);
+                section.push_back(dictionary.signatures[base + b]);
+            }
+        }
+        writeWords(output, section.data(), section.size());
+    }
+}
+
+}  // namespace io
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <ostream>
+#include <string>
+
+#include "algorithm/fault_dictionary.hpp"
+#include "core/circuit.hpp"
+
+namespace io {
+
+// .fdict layout (native 64-bit words):
+//   "FSIMDCT1", pattern_count, net_count, block_count, bitmap_words
+//   net_count names in .ans order, each a length word followed by bytes padded to 8
+//   net_count * 2 + 1 section offsets, relative to the end of the offset table
+//   Per (net, SA0/SA1) section: bitmap_words words whose bit b % 64 of word b / 64 marks
+//   block b as failing, then a (fail word, signature) pair per marked block, ascending
+// Block b covers patterns 64 * b .. 64 * b + 63; bit p % 64 of a fail word is pattern p.
+// Undetected faults cost only their bitmap.
+void writeFaultDictionaryFile(const core::Circuit& circuit,
+                              const algorithm::FaultDictionary& dictionary,
+                              const std::string& output_path);
+void writeFaultDictionary(const core::Circuit& circuit,
+                          const algorithm::FaultDictionary& dictionary, std::ostream& output);
+
+}  // namespace io
@@ -0,0 +1,157 @@
+#include "io/netlist_writer.hpp"
+
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t kNetsPerLine = 10;
+constexpr std::size_t kFlushBytes = std::size_t{1} << 20;
+
+// Keyword and instance-name prefix, as the ISCAS-85 files spell them (BUFF1 for buf).
+const char* keyword(core::GateType type) {
+    switch (type) {
+        case core::GateType::And:
+            return "and";
+        case core::GateType::Or:
+            return "or";
+        case core::GateType::Nand:
+            return "nand";
+        case core::GateType::Nor:
+            return "nor";
+        case core::GateType::Xor:
+            return "xor";
+        case core::GateType::Xnor:
+            return "xnor";
+        case core::GateType::Not:
+            return "not";
+        case core::GateType::Buf:
+            return "buf";
+        case core::GateType::Unknown:
+        default:
+            throw std::runtime_error("Cannot write a gate of unknown type");
+    }
+}
+
+std::string instancePrefix(core::GateType type, std::size_t fanin) {
+    const std::string name =
+        type == core::GateType::Buf ? "BUFF" : core::gateTypeToString(type);
+    return name + std::to_string(fanin);
+}
+
+void appendNet(std::string& out, std::uint32_t net) {
+    out += 'N';
+    out += std::to_string(net + 1);
+}
+
+// "<head>a,b,...;" with continuation lines indented under the first net.
+void appendNetList(std::string& out, const std::string& head,
+                   const std::vector<std::uint32_t>& nets, const char* close) {
+    out += head;
+    const std::string indent(head.size(), ' ');
+    for (std::size_t i = 0; i < nets.size(); ++i) {
+        if (i != 0) {
+            out += ',';
+            if (i % kNetsPerLine == 0) {
+                out += '\n';
+                out += indent;
+            }
+        }
+        appendNet(out, nets[i]);
+    }
+    out += close;
+    out += '\n';
+}
+
+}  // namespace
+
+namespace io {
+
+void writeVerilog(const core::SyntheticNetlist& netlist, const std::string& module_name,
+                  const std::string& output_path) {
+    std::ofstream output(output_path, std::ios::binary);
+    if (!output) {
+        throw std::runtime_error("Failed to open netlist output file: " + output_path);
+    }
+    std::string out;
+    auto flush = [&](bool force) {
+        if (force || out.size() >= kFlushBytes) {
+            output.write(out.data(), static_cast<std::streamsize>(out.size()));
+            out.clear();
+        }
+    };
+
+    const std::size_t gate_count = netlist.gateCount();
+    std::map<std::string, std::size_t> gate_kinds;
+    for (std::size_t g = 0; g < gate_count; ++g) {
+        ++gate_kinds[instancePrefix(netlist.types[g],
+                                    netlist.input_begin[g + 1] - netlist.input_begin[g])];
+    }
+    out += "// Verilog\n// " + module_name + " (synthetic, depth " +
+           std::to_string(netlist.depth) + ")\n";
+    out += "// Ninputs " + std::to_string(netlist.input_count) + '\n';
+    out += "// Noutputs " + std::to_string(netlist.outputs.size()) + '\n';
+    out += "// NtotalGates " + std::to_string(gate_count) + '\n';
+    for (const auto& [kind, count] : gate_kinds) {
+        out += "// " + kind + ' ' + std::to_string(count) + '\n';
+    }
+    out += '\n';
+
+    std::vector<std::uint32_t> inputs(netlist.input_count);
+    for (std::size_t i = 0; i < inputs.size(); ++i) {
+        inputs[i] = static_cast<std::uint32_t>(i);
+    }
+    std::vector<std::uint32_t> ports = inputs;
+    ports.insert(ports.end(), netlist.outputs.begin(), netlist.outputs.end());
+    appendNetList(out, "module " + module_name + " (", ports, ");");
+    out += '\n';
+    appendNetList(out, "input ", inputs, ";");
+    out += '\n';
+    appendNetList(out, "output ", netlist.outputs, ";");
+    out += '\n';
+
+    std::vector<std::uint32_t> wires;
+    wires.reserve(gate_count - netlist.outputs.size());
+    std::size_t next_output = 0;
+    for (std::size_t g = 0; g < gate_count; ++g) {
+        const auto net = static_cast<std::uint32_t>(netlist.input_count + g);
+        if (next_output < netlist.outputs.size() && netlist.outputs[next_output] == net) {
+            ++next_output;
+        } else {
+            wires.push_back(net);
+        }
+    }
+    if (!wires.empty()) {
+        appendNetList(out, "wire ", wires, ";");
+        out += '\n';
+    }
+    std::vector<std::uint32_t>().swap(wires);
+
+    for (std::size_t g = 0; g < gate_count; ++g) {
+        const std::uint32_t begin = netlist.input_begin[g];
+        const std::uint32_t end = netlist.input_begin[g + 1];
+        out += keyword(netlist.types[g]);
+        out += ' ';
+        out += instancePrefix(netlist.types[g], end - begin);
+        out += '_';
+        out += std::to_string(g + 1);
+        out += " (";
+        appendNet(out, static_cast<std::uint32_t>(netlist.input_count + g));
+        for (std::uint32_t i = begin; i < end; ++i) {
+            out += ", ";
+            appendNet(out, netlist.inputs[i]);
+        }
+        out += ");\n";
+        flush(false);
+    }
+    out += "\nendmodule\n";
+    flush(true);
+    if (!output) {
+        throw std::runtime_error("Failed to write netlist: " + output_path);
+    }
+}
+
+}  // namespace io
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <string>
+
+#include "core/netlist_generator.hpp"
+
+namespace io {
+
+// Writes `netlist` in the structural Verilog dialect of testcases/*.v: an ISCAS-style header
+// comment with gate statistics, ten nets per port/wire line, net k named N<k + 1>, and
+// instances named like NAND2_<index>.
+void writeVerilog(const core::SyntheticNetlist& netlist, const std::string& module_name,
+                  const std::string& output_path);
+
+}  // namespace io
@@ -1,5 +1,6 @@
 #include "io/pattern_loader.hpp"
 
+#include <cstdint>
 #include <fstream>
 #include <limits>
 #include <sstream>
@@ -39,6 +40,9 @@ int parseBit(const std::string& value) {
     if (value == "1") {
         return 1;
     }
+    if (value == "X" || value == "x") {
+        return core::kValueX;
+    }
     throw std::runtime_error("Invalid bit value: " + value);
 }
 
@@ -93,23 +97,88 @@ std::unordered_map<core::NetId, int> parseOutputSection(const std::string& secti
     return outputs;
 }
 
+struct PackedKeyHash {
+    std::size_t operator()(const std::vector<std::uint64_t>& key) const {
+        std::uint64_t hash = 1469598103934665603ULL;
+        for (auto word : key) {
+            hash ^= word + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+        }
+        return static_cast<std::size_t>(hash);
+    }
+};
+
+// Packs one bit per primary input followed by two bits (provided, value) per primary output.
+// Returns false for rows that do not assign every primary input exactly once.
+bool packRow(const io::PatternRow& row, const std::vector<int>& pi_index,
+             const std::vector<int>& po_index, std::size_t pi_count, std::size_t po_count,
+             std::vector<std::uint64_t>& key, std::vector<std::uint64_t>& assigned_bits) {
+    const std::size_t pi_words = (pi_count + 63) / 64;
+    key.assign(pi_words + (po_count * 2 + 63) / 64, 0);
+    assigned_bits.assign(pi_words, 0);
+
+    std::size_t assigned = 0;
+    for (const auto& entry : row.pattern.assignments) {
+        const int idx = entry.net < pi_index.size() ? pi_index[entry.net] : -1;
+        if (idx < 0) {
+            return false;
+        }
+        const auto bit = static_cast<std::size_t>(idx);
+        const std::uint64_t mask = std::uint64_t{1} << (bit % 64);
+        if (assigned_bits[bit / 64] & mask) {
+            return false;
+        }
+        assigned_bits[bit / 64] |= mask;
+        if (entry.value == core::kValueX) {
+            return false;
+        }
+        if (entry.value) {
+            key[bit / 64] |= mask;
+        }
+        ++assigned;
+    }
+    if (assigned != pi_count) {
+        return false;
+    }
+
+    for (const auto& kv : row.provided_outputs) {
+        const int idx = kv.first < po_index.size() ? po_index[kv.first] : -1;
+        if (idx < 0) {
+            return false;
+        }
+        if (kv.second == core::kValueX) {
+            return false;
+        }
+        const std::size_t bit = static_cast<std::size_t>(idx) * 2;
+        key[pi_words + bit / 64] |= std::uint64_t{1} << (bit % 64);
+        if (kv.second) {
+            key[pi_words + (bit + 1) / 64] |= std::uint64_t{1} << ((bit + 1) % 64);
+        }
+    }
+    return true;
+}
+
 }  // namespace
 
 namespace io {
 
-std::vector<PatternRow> loadPatterns(const core::Circuit& circuit, const std::string& path) {
+std::vector<PatternRow> loadPatterns(const core::Circuit& circuit, const std::string& path,
+                                     std::size_t first_row) {
     std::ifstream input(path);
     if (!input) {
         throw std::runtime_error("Unable to open pattern file: " + path);
     }
 
     std::vector<PatternRow> rows;
+    std::size_t row_index = 0;
     std::string line;
     while (std::getline(input, line)) {
         line = trim(line);
         if (line.empty()) {
             continue;
         }
+        if (row_index++ < first_row) {
+            continue;
+        }
         PatternRow row;
         const auto pipe_pos = line.find('|');
         std::string pattern_section = pipe_pos == std::string::npos ? line : line.substr(0, pipe_pos);
@@ -122,10 +191,108 @@ std::vector<PatternRow> loadPatterns(const core::Circuit& circuit, const std::st
         rows.push_back(std::move(row));
     }
 
-    if (rows.empty()) {
+    if (row_index == 0) {
         throw std::runtime_error("Pattern file contains no patterns: " + path);
     }
+    if (row_index < first_row) {
+        throw std::runtime_error("Pattern file has " + std::to_string(row_index) +
+                                 " patterns, fewer than the " + std::to_string(first_row) +
+                                 " to skip: " + path);
+    }
     return rows;
 }
 
+void writeSelectedPatterns(const std::string& source_path, const std::vector<std::size_t>& rows,
+                           const std::string& output_path) {
+    std::ifstream input(source_path);
+    if (!input) {
+        throw std::runtime_error("Unable to open pattern file: " + source_path);
+    }
+    std::ofstream output(output_path, std::ios::binary);
+    if (!output) {
+        throw std::runtime_error("Unable to open output file: " + output_path);
+    }
+    std::size_t row_index = 0;
+    std::size_t next = 0;
+    std::string line;
+    while (next < rows.size() && std::getline(input, line)) {
+        line = trim(line);
+        if (line.empty()) {
+            continue;
+        }
+        if (row_index++ == rows[next]) {
+            output << line << '\n';
+            ++next;
+        }
+    }
+    if (next != rows.size()) {
+        throw std::runtime_error("Pattern file has fewer rows than selected: " + source_path);
+    }
+    if (!output) {
+        throw std::runtime_error("Failed to write pattern file: " + output_path);
+    }
+}
+
+bool hasUnknownValues(const std::vector<PatternRow>& rows) {
+    for (const auto& row : rows) {
+        for (const auto& entry : row.pattern.assignments) {
+            if (entry.value == core::kValueX) {
+                return true;
+            }
+        }
+        for (const auto& kv : row.provided_outputs) {
+            if (kv.second == core::kValueX) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+DeduplicatedPatterns deduplicatePatterns(const core::Circuit& circuit,
+                                         std::vector<PatternRow> rows) {
+    const auto& inputs = circuit.primaryInputs();
+    const auto& outputs = circuit.primaryOutputs();
+    std::vector<int> pi_index(circuit.netCount(), -1);
+    std::vector<int> po_index(circuit.netCount(), -1);
+    for (std::size_t i = 0; i < inputs.size(); ++i) {
+        pi_index[inputs[i]] = static_cast<int>(i);
+    }
+    for (std::size_t i = 0; i < outputs.size(); ++i) {
+        po_index[outputs[i]] = static_cast<int>(i);
+    }
+
+    std::unordered_map<std::vector<std::uint64_t>, std::size_t, PackedKeyHash> seen;
+    seen.reserve(rows.size());
+    std::vector<std::size_t> source_row(rows.size());
+    std::vector<std::size_t> keep;
+    keep.reserve(rows.size());
+    std::vector<std::uint64_t> key;
+    std::vector<std::uint64_t> assigned_bits;
+    for (std::size_t i = 0; i < rows.size(); ++i) {
+        if (packRow(rows[i], pi_index, po_index, inputs.size(), outputs.size(), key,
+                    assigned_bits)) {
+            const auto [it, inserted] = seen.emplace(key, keep.size());
+            if (!inserted) {
+                source_row[i] = it->second;
+                continue;
+            }
+        }
+        source_row[i] = keep.size();
+        keep.push_back(i);
+    }
+
+    DeduplicatedPatterns result;
+    if (keep.size() == rows.size()) {
+        result.unique_rows = std::move(rows);
+        return result;
+    }
+    result.unique_rows.reserve(keep.size());
+    for (auto index : keep) {
+        result.unique_rows.push_back(std::move(rows[index]));
+    }
+    result.source_row = std::move(source_row);
+    return result;
+}
+
 }  // namespace io
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -13,6 +14,29 @@ struct PatternRow {
     std::unordered_map<core::NetId, int> provided_outputs;
 };
 
-std::vector<PatternRow> loadPatterns(const core::Circuit& circuit, const std::string& path);
+// Distinct rows plus, for every original row, the index of its representative.
+struct DeduplicatedPatterns {
+    std::vector<PatternRow> unique_rows;
+    // Empty when no row repeats, meaning original row i is unique row i.
+    std::vector<std::size_t> source_row;
+};
+
+// Rows before `first_row` are skipped without being parsed; the result may then be empty.
+std::vector<PatternRow> loadPatterns(const core::Circuit& circuit, const std::string& path,
+                                     std::size_t first_row = 0);
+
+// Copies the pattern lines of `rows` (indices as counted by loadPatterns, ascending) from
+// `source_path` to `output_path` unchanged.
+void writeSelectedPatterns(const std::string& source_path, const std::vector<std::size_t>& rows,
+                           const std::string& output_path);
+
+// True when any input or provided output is X (core::kValueX).
+bool hasUnknownValues(const std::vector<PatternRow>& rows);
+
+// Collapses rows whose packed primary-input vector and provided outputs are identical.
+// Rows that assign anything other than each primary input exactly once, or contain X, are
+// kept as-is.
+DeduplicatedPatterns deduplicatePatterns(const core::Circuit& circuit,
+                                         std::vector<PatternRow> rows);
 
 }  // namespace io
@@ -52,14 +52,15 @@ core::Pattern parsePatternLine(const std::string& line, const core::Circuit& cir
         if (net_name.empty() || value_str.empty()) {
             throw std::runtime_error("Invalid pattern token: " + section);
         }
-        if (value_str != "0" && value_str != "1") {
-            throw std::runtime_error("Pattern values must be 0 or 1 for net " + net_name);
+        if (value_str != "0" && value_str != "1" && value_str != "X" && value_str != "x") {
+            throw std::runtime_error("Pattern values must be 0, 1 or X for net " + net_name);
         }
         const auto net = circuit.netId(net_name);
         if (net == std::numeric_limits<core::NetId>::max()) {
             throw std::runtime_error("Pattern references unknown net: " + net_name);
         }
-        pattern.assignments.push_back({net, value_str == "1" ? 1 : 0});
+        const int value = value_str == "1" ? 1 : (value_str == "0" ? 0 : core::kValueX);
+        pattern.assignments.push_back({net, value});
     }
 
     if (pattern.assignments.empty()) {
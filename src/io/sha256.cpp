@@ -0,0 +1,239 @@
+#include "io/sha256.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <cpuid.h>
+#include <immintrin.h>
+#define SHA256_HAVE_SHA_NI 1
+#endif
+
+namespace {
+
+constexpr std::uint32_t kRoundConstants[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4,
+    0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe,
+    0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f,
+    0x4a7484aa, 0x5cb0a9dc, 0x76f988da, 0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+    0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc,
+    0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+    0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070, 0x19a4c116,
+    0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7,
+    0xc67178f2};
+
+std::uint32_t rotr(std::uint32_t value, int bits) {
+    return (value >> bits) | (value << (32 - bits));
+}
+
+void compressPortable(std::uint32_t* state, const unsigned char* block) {
+    std::uint32_t w[64];
+    for (int i = 0; i < 16; ++i) {
+        w[i] = (static_cast<std::uint32_t>(block[4 * i]) << 24) |
+               (static_cast<std::uint32_t>(block[4 * i + 1]) << 16) |
+               (static_cast<std::uint32_t>(block[4 * i + 2]) << 8) |
+               static_cast<std::uint32_t>(block[4 * i + 3]);
+    }
+    for (int i = 16; i < 64; ++i) {
+        const std::uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        const std::uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    std::uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+    std::uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+    for (int i = 0; i < 64; ++i) {
+        const std::uint32_t s1 = rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25);
+        const std::uint32_t ch = (e & f) ^ (~e & g);
+        const std::uint32_t t1 = h + s1 + ch + kRoundConstants[i] + w[i];
+        const std::uint32_t s0 = rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22);
+        const std::uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
+        const std::uint32_t t2 = s0 + maj;
+        h = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+    state[5] += f;
+    state[6] += g;
+    state[7] += h;
+}
+
+#ifdef SHA256_HAVE_SHA_NI
+
+bool cpuHasShaExtensions() {
+    unsigned eax = 0, ebx = 0, ecx = 0, edx = 0;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx) || !(ecx & bit_SSE4_1) || !(ecx & bit_SSSE3)) {
+        return false;
+    }
+    return __get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) && (ebx & bit_SHA);
+}
+
+// The SHA-NI instructions keep the state as (ABEF, CDGH) and run two rounds per
+// sha256rnds2; message words are scheduled four at a time with sha256msg1/msg2.
+__attribute__((target("sha,sse4.1"))) void compressShaNi(std::uint32_t* state,
+                                                         const unsigned char* data,
+                                                         std::size_t count) {
+    const __m128i byte_swap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+    __m128i tmp = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(state)),
+                                    0xB1);
+    __m128i state1 =
+        _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(state + 4)), 0x1B);
+    __m128i state0 = _mm_alignr_epi8(tmp, state1, 8);
+    state1 = _mm_blend_epi16(state1, tmp, 0xF0);
+
+    for (; count > 0; --count, data += 64) {
+        const __m128i abef = state0;
+        const __m128i cdgh = state1;
+        // msg[g % 4] holds message words 4g .. 4g + 3 once group g is scheduled.
+        __m128i msg[4];
+#pragma GCC unroll 16
+        for (int g = 0; g < 16; ++g) {
+            __m128i words;
+            if (g < 4) {
+                words = _mm_shuffle_epi8(
+                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 16 * g)), byte_swap);
+            } else {
+                words = _mm_sha256msg1_epu32(msg[g % 4], msg[(g + 1) % 4]);
+                words = _mm_add_epi32(words,
+                                      _mm_alignr_epi8(msg[(g + 3) % 4], msg[(g + 2) % 4], 4));
+                words = _mm_sha256msg2_epu32(words, msg[(g + 3) % 4]);
+            }
+            msg[g % 4] = words;
+            __m128i k = _mm_add_epi32(
+                words, _mm_loadu_si128(reinterpret_cast<const __m128i*>(kRoundConstants + 4 * g)));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, k);
+            k = _mm_shuffle_epi32(k, 0x0E);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, k);
+        }
+        state0 = _mm_add_epi32(state0, abef);
+        state1 = _mm_add_epi32(state1, cdgh);
+    }
+
+    tmp = _mm_shuffle_epi32(state0, 0x1B);
+    state1 = _mm_shuffle_epi32(state1, 0xB1);
+    state0 = _mm_blend_epi16(tmp, state1, 0xF0);
+    state1 = _mm_alignr_epi8(state1, tmp, 8);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state), state0);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state + 4), state1);
+}
+
+#endif  // SHA256_HAVE_SHA_NI
+
+}  // namespace
+
+namespace io {
+
+Sha256::Sha256()
+    : state_{0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c,
+             0x1f83d9ab, 0x5be0cd19} {}
+
+void Sha256::update(const void* data, std::size_t size) {
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    total_bytes_ += size;
+    if (block_size_ != 0) {
+        const std::size_t take = std::min(size, block_.size() - block_size_);
+        std::memcpy(block_.data() + block_size_, bytes, take);
+        block_size_ += take;
+        bytes += take;
+        size -= take;
+        if (block_size_ < block_.size()) {
+            return;
+        }
+        compress(block_.data(), 1);
+        block_size_ = 0;
+    }
+    const std::size_t whole_blocks = size / block_.size();
+    compress(bytes, whole_blocks);
+    bytes += whole_blocks * block_.size();
+    size -= whole_blocks * block_.size();
+    std::memcpy(block_.data(), bytes, size);
+    block_size_ = size;
+}
+
+std::string Sha256::hexDigest() {
+    const std::uint64_t bit_length = total_bytes_ * 8;
+    const unsigned char pad = 0x80;
+    update(&pad, 1);
+    const unsigned char zero = 0;
+    while (block_size_ != 56) {
+        update(&zero, 1);
+    }
+    unsigned char length[8];
+    for (int i = 0; i < 8; ++i) {
+        length[i] = static_cast<unsigned char>(bit_length >> (56 - 8 * i));
+    }
+    update(length, sizeof(length));
+
+    static const char* const kHex = "0123456789abcdef";
+    std::string digest;
+    digest.reserve(64);
+    for (std::uint32_t word : state_) {
+        for (int shift = 28; shift >= 0; shift -= 4) {
+            digest += kHex[(word >> shift) & 0xF];
+        }
+    }
+    return digest;
+}
+
+void Sha256::compress(const unsigned char* blocks, std::size_t count) {
+#ifdef SHA256_HAVE_SHA_NI
+    static const bool use_sha_ni = cpuHasShaExtensions();
+    if (use_sha_ni) {
+        compressShaNi(state_.data(), blocks, count);
+        return;
+    }
+#endif
+    for (std::size_t i = 0; i < count; ++i) {
+        compressPortable(state_.data(), blocks + 64 * i);
+    }
+}
+
+Sha256Buf::Sha256Buf(Sha256& hash, std::streambuf* next) : hash_(hash), next_(next) {
+    setp(buffer_.data(), buffer_.data() + buffer_.size());
+}
+
+Sha256Buf::~Sha256Buf() {
+    flushBuffer();
+}
+
+Sha256Buf::int_type Sha256Buf::overflow(int_type ch) {
+    if (!flushBuffer()) {
+        return traits_type::eof();
+    }
+    if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+        *pptr() = traits_type::to_char_type(ch);
+        pbump(1);
+    }
+    return traits_type::not_eof(ch);
+}
+
+int Sha256Buf::sync() {
+    if (!flushBuffer()) {
+        return -1;
+    }
+    return next_ && next_->pubsync() != 0 ? -1 : 0;
+}
+
+bool Sha256Buf::flushBuffer() {
+    const std::streamsize size = pptr() - pbase();
+    if (size == 0) {
+        return true;
+    }
+    hash_.update(pbase(), static_cast<std::size_t>(size));
+    const bool written = !next_ || next_->sputn(pbase(), size) == size;
+    setp(buffer_.data(), buffer_.data() + buffer_.size());
+    return written;
+}
+
+}  // namespace io
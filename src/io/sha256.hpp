@@ -0,0 +1,48 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <streambuf>
+#include <string>
+
+namespace io {
+
+// Incremental SHA-256 (FIPS 180-4), so answers can be hashed while they are formatted.
+class Sha256 {
+public:
+    Sha256();
+
+    void update(const void* data, std::size_t size);
+    // Finishes the digest and returns it as lowercase hex, matching `sha256sum`.
+    std::string hexDigest();
+
+private:
+    std::array<std::uint32_t, 8> state_;
+    std::array<unsigned char, 64> block_{};
+    std::size_t block_size_{0};
+    std::uint64_t total_bytes_{0};
+
+    // Processes `count` consecutive 64-byte blocks, using the x86 SHA extensions when present.
+    void compress(const unsigned char* blocks, std::size_t count);
+};
+
+// Output buffer that feeds every byte to a Sha256 and, if given, forwards it to `next`.
+class Sha256Buf : public std::streambuf {
+public:
+    explicit Sha256Buf(Sha256& hash, std::streambuf* next = nullptr);
+    ~Sha256Buf() override;
+
+protected:
+    int_type overflow(int_type ch) override;
+    int sync() override;
+
+private:
+    Sha256& hash_;
+    std::streambuf* next_;
+    std::array<char, 1 << 16> buffer_;
+
+    bool flushBuffer();
+};
+
+}  // namespace io
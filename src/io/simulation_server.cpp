@@ -0,0 +1,318 @@
+#include "io/simulation_server.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "io/binary_answers.hpp"
+#include "io/circuit_parser.hpp"
+
+namespace {
+
+constexpr char kRequestMagic[8] = {'F', 'S', 'I', 'M', 'R', 'Q', '0', '1'};
+constexpr std::size_t kRequestHeaderWords = 5;
+// Upper bound on one request's packed inputs, so a corrupt header cannot exhaust memory.
+constexpr std::uint64_t kMaxRequestWords = std::uint64_t{1} << 28;
+
+struct LoadedCircuit {
+    core::Circuit circuit;
+    std::unique_ptr<core::Simulator> good;
+};
+
+// Returns false on a clean end of stream before the first byte.
+bool readExact(int fd, void* data, std::size_t size) {
+    auto* bytes = static_cast<char*>(data);
+    std::size_t done = 0;
+    while (done < size) {
+        const ssize_t got = ::read(fd, bytes + done, size - done);
+        if (got == 0 && done == 0) {
+            return false;
+        }
+        if (got <= 0) {
+            if (got < 0 && errno == EINTR) {
+                continue;
+            }
+            throw std::runtime_error("Connection closed mid-message");
+        }
+        done += static_cast<std::size_t>(got);
+    }
+    return true;
+}
+
+void writeExact(int fd, const void* data, std::size_t size) {
+    const auto* bytes = static_cast<const char*>(data);
+    while (size > 0) {
+        const ssize_t sent = ::send(fd, bytes, size, MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::runtime_error("Failed to write to socket");
+        }
+        bytes += sent;
+        size -= static_cast<std::size_t>(sent);
+    }
+}
+
+void sendResponse(int fd, std::uint64_t status, const std::string& payload) {
+    const std::uint64_t header[] = {status, payload.size()};
+    writeExact(fd, header, sizeof(header));
+    writeExact(fd, payload.data(), payload.size());
+}
+
+sockaddr_un socketAddress(const std::string& socket_path) {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (socket_path.size() >= sizeof(address.sun_path)) {
+        throw std::runtime_error("Socket path too long: " + socket_path);
+    }
+    std::memcpy(address.sun_path, socket_path.c_str(), socket_path.size() + 1);
+    return address;
+}
+
+void appendWord(std::string& payload, std::uint64_t value) {
+    payload.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+std::string coveragePayload(const algorithm::FaultSimulator& simulator, bool first_detection) {
+    const auto& net_order = simulator.answerNetOrder();
+    const std::size_t fault_count = net_order.size() * 2;
+    const std::uint64_t undetected = std::numeric_limits<std::uint64_t>::max();
+    std::vector<std::uint64_t> first(fault_count, undetected);
+    for (std::size_t p = 0; p < simulator.patternCount(); ++p) {
+        const auto& results = simulator.answers.get(p);
+        for (std::size_t k = 0; k < net_order.size(); ++k) {
+            const auto& result = results[net_order[k]];
+            if (!result.stuck0_eq && first[2 * k] == undetected) {
+                first[2 * k] = p;
+            }
+            if (!result.stuck1_eq && first[2 * k + 1] == undetected) {
+                first[2 * k + 1] = p;
+            }
+        }
+    }
+
+    std::string payload;
+    if (first_detection) {
+        for (const std::uint64_t index : first) {
+            appendWord(payload, index);
+        }
+        return payload;
+    }
+    std::vector<std::uint64_t> bitmap((fault_count + 63) / 64, 0);
+    std::uint64_t detected = 0;
+    for (std::size_t f = 0; f < fault_count; ++f) {
+        if (first[f] != undetected) {
+            bitmap[f / 64] |= std::uint64_t{1} << (f % 64);
+            ++detected;
+        }
+    }
+    appendWord(payload, detected);
+    appendWord(payload, fault_count);
+    for (const std::uint64_t word : bitmap) {
+        appendWord(payload, word);
+    }
+    return payload;
+}
+
+class SimulationServer {
+public:
+    explicit SimulationServer(io::SimulatorFactory factory) : factory_(std::move(factory)) {}
+
+    // Handles requests on one connection; returns true once a Shutdown request is served.
+    bool serveConnection(int fd) {
+        while (true) {
+            std::uint64_t header[kRequestHeaderWords] = {};
+            if (!readExact(fd, header, sizeof(header))) {
+                return false;
+            }
+            if (std::memcmp(&header[0], kRequestMagic, sizeof(kRequestMagic)) != 0) {
+                throw std::runtime_error("Malformed simulation request");
+            }
+            const auto mode = static_cast<io::ServerMode>(header[1]);
+            const std::uint64_t name_length = header[2];
+            const std::uint64_t pattern_count = header[3];
+            const std::uint64_t input_count = header[4];
+            const std::uint64_t words = (pattern_count + 63) / 64;
+            if (name_length > 4096 || pattern_count > kMaxRequestWords * 64 ||
+                (words != 0 && input_count > kMaxRequestWords / words)) {
+                throw std::runtime_error("Simulation request too large");
+            }
+            std::string circuit_id((name_length + 7) / 8 * 8, '\0');
+            core::PackedPatterns packed;
+            packed.pattern_count = static_cast<std::size_t>(pattern_count);
+            packed.word_count = static_cast<std::size_t>(words);
+            packed.inputs.resize(static_cast<std::size_t>(input_count * words));
+            if (!readExact(fd, circuit_id.data(), circuit_id.size()) ||
+                !readExact(fd, packed.inputs.data(),
+                           packed.inputs.size() * sizeof(std::uint64_t))) {
+                throw std::runtime_error("Connection closed mid-message");
+            }
+            circuit_id.resize(static_cast<std::size_t>(name_length));
+
+            if (mode == io::ServerMode::Shutdown) {
+                sendResponse(fd, 0, "");
+                return true;
+            }
+            try {
+                sendResponse(fd, 0, simulate(circuit_id, mode, packed));
+            } catch (const std::exception& ex) {
+                sendResponse(fd, 1, ex.what());
+            }
+        }
+    }
+
+private:
+    io::SimulatorFactory factory_;
+    std::map<std::string, std::unique_ptr<LoadedCircuit>> circuits_;
+    std::vector<std::uint64_t> po_words_;
+
+    LoadedCircuit& circuit(const std::string& circuit_id) {
+        auto& slot = circuits_[circuit_id];
+        if (!slot) {
+            auto loaded = std::make_unique<LoadedCircuit>();
+            loaded->circuit = io::parseCircuit("testcases/" + circuit_id + ".v");
+            loaded->good = std::make_unique<core::Simulator>(loaded->circuit);
+            slot = std::move(loaded);
+        }
+        return *slot;
+    }
+
+    std::string simulate(const std::string& circuit_id, io::ServerMode mode,
+                         const core::PackedPatterns& packed) {
+        if (mode != io::ServerMode::Full && mode != io::ServerMode::Coverage &&
+            mode != io::ServerMode::DetectOnly) {
+            throw std::runtime_error("Unknown simulation mode");
+        }
+        LoadedCircuit& loaded = circuit(circuit_id);
+        const auto& inputs = loaded.circuit.primaryInputs();
+        const auto& outputs = loaded.circuit.primaryOutputs();
+        if (packed.inputs.size() != inputs.size() * packed.word_count) {
+            throw std::runtime_error("Request input count does not match circuit " + circuit_id);
+        }
+        loaded.good->simulateWords(packed, po_words_);
+
+        // Golden outputs come from the resident good-machine simulator, as in the generator.
+        std::vector<io::PatternRow> rows(packed.pattern_count);
+        for (std::size_t p = 0; p < packed.pattern_count; ++p) {
+            const std::size_t word = p / 64;
+            const std::size_t lane = p % 64;
+            auto& assignments = rows[p].pattern.assignments;
+            assignments.resize(inputs.size());
+            for (std::size_t i = 0; i < inputs.size(); ++i) {
+                assignments[i].net = inputs[i];
+                assignments[i].value =
+                    static_cast<int>((packed.inputs[i * packed.word_count + word] >> lane) & 1U);
+            }
+            for (std::size_t j = 0; j < outputs.size(); ++j) {
+                rows[p].provided_outputs[outputs[j]] =
+                    static_cast<int>((po_words_[j * packed.word_count + word] >> lane) & 1U);
+            }
+        }
+
+        auto simulator = factory_(loaded.circuit, rows);
+        simulator->start();
+        if (mode == io::ServerMode::Full) {
+            std::ostringstream payload;
+            io::writeBinaryAnswers(*simulator, payload);
+            return payload.str();
+        }
+        return coveragePayload(*simulator, mode == io::ServerMode::DetectOnly);
+    }
+};
+
+}  // namespace
+
+namespace io {
+
+void runSimulationServer(const std::string& socket_path, SimulatorFactory factory) {
+    const sockaddr_un address = socketAddress(socket_path);
+    const int listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0) {
+        throw std::runtime_error("Unable to create socket");
+    }
+    ::unlink(socket_path.c_str());
+    if (::bind(listener, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+        ::listen(listener, 16) != 0) {
+        ::close(listener);
+        throw std::runtime_error("Unable to listen on socket: " + socket_path);
+    }
+
+    SimulationServer server(std::move(factory));
+    bool stop = false;
+    while (!stop) {
+        const int fd = ::accept(listener, nullptr, nullptr);
+        if (fd < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        try {
+            stop = server.serveConnection(fd);
+        } catch (const std::exception&) {
+            // A broken or malformed connection only ends that connection.
+        }
+        ::close(fd);
+    }
+    ::close(listener);
+    ::unlink(socket_path.c_str());
+}
+
+SimulationClient::SimulationClient(const std::string& socket_path) {
+    const sockaddr_un address = socketAddress(socket_path);
+    fd_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd_ < 0 ||
+        ::connect(fd_, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+        if (fd_ >= 0) {
+            ::close(fd_);
+        }
+        throw std::runtime_error("Unable to connect to simulation server: " + socket_path);
+    }
+}
+
+SimulationClient::~SimulationClient() {
+    ::close(fd_);
+}
+
+std::vector<char> SimulationClient::request(const std::string& circuit_id, ServerMode mode,
+                                            const core::PackedPatterns& patterns) {
+    std::uint64_t header[kRequestHeaderWords] = {};
+    std::memcpy(&header[0], kRequestMagic, sizeof(kRequestMagic));
+    header[1] = static_cast<std::uint64_t>(mode);
+    header[2] = circuit_id.size();
+    header[3] = patterns.pattern_count;
+    header[4] = patterns.word_count == 0 ? 0 : patterns.inputs.size() / patterns.word_count;
+    std::string padded_id = circuit_id;
+    padded_id.resize((circuit_id.size() + 7) / 8 * 8, '\0');
+    writeExact(fd_, header, sizeof(header));
+    writeExact(fd_, padded_id.data(), padded_id.size());
+    writeExact(fd_, patterns.inputs.data(), patterns.inputs.size() * sizeof(std::uint64_t));
+
+    std::uint64_t response[2] = {};
+    if (!readExact(fd_, response, sizeof(response))) {
+        throw std::runtime_error("Simulation server closed the connection");
+    }
+    std::vector<char> payload(static_cast<std::size_t>(response[1]));
+    if (!payload.empty() && !readExact(fd_, payload.data(), payload.size())) {
+        throw std::runtime_error("Simulation server closed the connection");
+    }
+    if (response[0] != 0) {
+        throw std::runtime_error("Simulation server error: " +
+                                 std::string(payload.begin(), payload.end()));
+    }
+    return payload;
+}
+
+void SimulationClient::shutdown() {
+    request("", ServerMode::Shutdown, core::PackedPatterns{});
+}
+
+}  // namespace io
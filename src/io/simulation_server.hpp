@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "algorithm/fault_simulator.hpp"
+#include "core/circuit.hpp"
+#include "core/simulator.hpp"
+
+namespace io {
+
+// Request:  "FSIMRQ01", mode, circuit-id length, pattern_count, input_count, the circuit id
+//           padded to 8 bytes, then PackedPatterns::inputs (primaryInputs() order).
+// Response: status (0 = ok, else the payload is an error message), payload bytes, payload.
+//   Full:       the .ansb stream of the batch (see binary_answers.hpp).
+//   Coverage:   detected fault count, fault count, then a bitmap with bit 2k / 2k+1 set when
+//               SA0 / SA1 of the k-th net in .ans order is detected by some pattern.
+//   DetectOnly: per fault in the same order, the first detecting pattern or ~0.
+// Words are native 64-bit. One connection may carry any number of requests.
+enum class ServerMode : std::uint64_t { Full = 0, Coverage = 1, DetectOnly = 2, Shutdown = 3 };
+
+using SimulatorFactory = std::function<std::unique_ptr<algorithm::FaultSimulator>(
+    const core::Circuit&, const std::vector<PatternRow>&)>;
+
+// Serves requests on a Unix domain socket until a Shutdown request arrives. Circuit ids name
+// testcases/<id>.v; each circuit is parsed and levelized once, on first use.
+void runSimulationServer(const std::string& socket_path, SimulatorFactory factory);
+
+class SimulationClient {
+public:
+    explicit SimulationClient(const std::string& socket_path);
+    ~SimulationClient();
+    SimulationClient(const SimulationClient&) = delete;
+    SimulationClient& operator=(const SimulationClient&) = delete;
+
+    // Returns the response payload; a server-side error is rethrown here.
+    std::vector<char> request(const std::string& circuit_id, ServerMode mode,
+                              const core::PackedPatterns& patterns);
+    void shutdown();
+
+private:
+    int fd_{-1};
+};
+
+}  // namespace io
@@ -1,20 +1,47 @@
 // Fault simulation front-end that reads pre-generated patterns and writes answers.
 
 #include <algorithm>
+#include <chrono>
+#include <cstdint>
 #include <cstdlib>
 #include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <stdexcept>
 #include <string>
 #include <sys/time.h>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 #include "algorithm/baseline_simulator.hpp"
 #include "algorithm/batch1_mt_fault.hpp"
+#include "algorithm/batch64_mt_fault.hpp"
 #include "algorithm/batch_64_baseline.hpp"
 #include "algorithm/batch_baseline.hpp"
 #include "algorithm/bit_parallel_simulator.hpp"
+#include "algorithm/checkpointed_simulator.hpp"
+#include "algorithm/fault_dictionary.hpp"
+#include "algorithm/fault_sampling.hpp"
+#include "algorithm/hybrid_mpi_fault.hpp"
+#include "algorithm/test_compaction.hpp"
+#include "algorithm/thread_scaling.hpp"
+#include "algorithm/transition_fault.hpp"
+#include "core/simulator.hpp"
+#include "core/truth_table.hpp"
 #include "io/answer_writer.hpp"
+#include "io/binary_answers.hpp"
 #include "io/circuit_parser.hpp"
+#include "io/fault_dictionary_writer.hpp"
 #include "io/pattern_loader.hpp"
+#include "io/simulation_server.hpp"
 
 namespace {
 
@@ -46,60 +73,819 @@ double getTimeStamp() {
 }
 
 void printUsage(const char* program) {
-    std::cerr << "Usage: " << program << " <circuit> <output-path>\n";
+    std::cerr << "Usage: " << program
+              << " <circuit> <output-path> [--append <previous-ans> <pattern-count>]\n";
+    std::cerr << "       [--checkpoint <path> [--checkpoint-chunk <patterns>] [--resume]]\n";
+    std::cerr << "       [--transition]\n";
+    std::cerr << "       " << program << " <circuit> --sample-faults <count> [--seed <seed>]\n";
+    std::cerr << "       " << program << " <circuit> --verify <sha256|sha-file> [--checkpoint ...]\n";
+    std::cerr << "       " << program << " --ansb-to-text <answers.ansb> <output.ans>\n";
+    std::cerr << "       " << program << " --compact <circuit> <output.in>\n";
+    std::cerr << "       " << program << " --dictionary <circuit> <output.fdict>\n";
+    std::cerr << "       " << program << " --batch <jobs-file> (<output-dir> | --verify)\n";
+    std::cerr << "       " << program
+              << " --scaling <output.csv> <circuit>... [--threads N] [--repeat R]"
+                 " [--engines a,b,...]\n";
+    std::cerr << "       " << program << " --bench-eval <circuit> [--words W] [--repeat R]\n";
+    std::cerr << "       " << program << " --serve <socket>\n";
+    std::cerr << "       " << program
+              << " --client <socket> <circuit> <output> [full|coverage|detect|shutdown]\n";
     std::cerr << "  circuit: testcase basename or .v file under testcases/\n";
+    std::cerr << "  output-path: written as bit-packed binary answers when it ends in .ansb\n";
+    std::cerr << "  --append: reuse <previous-ans>, which covers the first <pattern-count> patterns,\n"
+                 "            and only simulate the rows after them\n";
+    std::cerr << "  --checkpoint: record each finished chunk (default 1024 patterns) in <path>\n";
+    std::cerr << "  --resume: continue from the chunks already recorded in the checkpoint\n";
+    std::cerr << "  --transition: grade slow-to-rise/slow-to-fall faults; rows 2i and 2i+1 of the\n"
+                 "                .in are the launch and capture vectors of pair i\n";
+    std::cerr << "  --sample-faults: simulate a stratified random sample of <count> stuck-at faults\n"
+                 "                   (default seed 42) and estimate coverage with a 95% interval\n";
+    std::cerr << "  --verify: hash the answers in memory and compare them with the expected digest\n"
+                 "            instead of writing an output file\n";
+    std::cerr << "  --compact: keep only the rows reverse-order fault simulation needs to reach the\n"
+                 "             same stuck-at coverage and write them to <output.in>\n";
+    std::cerr << "  --dictionary: record, per stuck-at fault and 64-pattern block, which patterns fail\n"
+                 "                and a hash of which outputs fail in them, as a binary .fdict\n";
+    std::cerr << "  --batch: run every circuit listed in <jobs-file> (config/pattern_targets.txt\n"
+                 "           layout) concurrently, largest first, and print a timing summary\n";
+    std::cerr << "  --scaling: time each OpenMP engine at 1..N threads (default: all cores), R runs\n"
+                 "             each (default 3), and write speedup, efficiency, load imbalance\n"
+                 "             and memory bandwidth as CSV\n";
+    std::cerr << "  --bench-eval: time the switch-based and truth-table good-machine evaluators on\n"
+                 "                W random 64-pattern words (default 16), best of R (default 20)\n";
+    std::cerr << "  --serve: keep circuits loaded and answer packed-pattern requests on a Unix socket\n";
+    std::cerr << "  --client: send testcases/<circuit>.in to a server and save the raw response\n"
+                 "            (an .ansb stream for full)\n";
 }
 
-}  // namespace
+bool isHexDigest(const std::string& text) {
+    return text.size() == 64 &&
+           std::all_of(text.begin(), text.end(), [](char ch) {
+               return (ch >= '0' && ch <= '9') || (ch >= 'a' && ch <= 'f');
+           });
+}
 
-int main(int argc, char** argv) {
-    if (argc != 3) {
-        printUsage(argv[0]);
-        return EXIT_FAILURE;
+// Accepts either the digest itself or a file holding it (such as testcases/<ckt>.ans.sha).
+std::string expectedDigest(const std::string& arg) {
+    if (isHexDigest(arg)) {
+        return arg;
     }
+    std::ifstream input(arg);
+    std::string digest;
+    if (!input || !(input >> digest) || !isHexDigest(digest)) {
+        throw std::runtime_error("Expected a SHA-256 hex digest or a .sha file: " + arg);
+    }
+    return digest;
+}
 
-    const std::string circuit_arg = argv[1];
-    const std::string output_path = argv[2];
-
-    try {
-        std::cerr << "Parsing circuit...\n";
-        const std::string circuit_file = circuitFileName(circuit_arg);
-        const std::string base_name = circuitBaseName(circuit_file);
-        const std::string circuit_path = "testcases/" + circuit_file;
-        const std::string pattern_path = "testcases/" + base_name + ".in";
-
-        auto circuit = io::parseCircuit(circuit_path);
-        auto rows = io::loadPatterns(circuit, pattern_path);
-
-        // Select simulator via compile-time flag. Default keeps BatchBaseline for prior behavior.
+// Select simulator via compile-time flag. Default keeps BatchBaseline for prior behavior.
+std::unique_ptr<algorithm::FaultSimulator> makeSimulator(const core::Circuit& circuit,
+                                                         const std::vector<io::PatternRow>& rows) {
 #ifdef BATCH64_MT_FAULT
-        algorithm::Batch64MtFaultSimulator simulator(circuit, rows);
+    return std::make_unique<algorithm::Batch64MtFaultSimulator>(circuit, rows);
 #elif defined(BATCH1_MT_FAULT)
-        algorithm::Batch1MtFaultSimulator simulator(circuit, rows);
+    return std::make_unique<algorithm::Batch1MtFaultSimulator>(circuit, rows);
 #elif defined(BATCH64)
-        algorithm::Batch64BaselineSimulator simulator(circuit, rows);
+    return std::make_unique<algorithm::Batch64BaselineSimulator>(circuit, rows);
 #elif defined(BATCHBASELINE)
-        algorithm::BatchBaselineSimulator simulator(circuit, rows);
+    return std::make_unique<algorithm::BatchBaselineSimulator>(circuit, rows);
 #elif defined(BITPARALLEL)
-        algorithm::BitParallelSimulator simulator(circuit, rows);
+    return std::make_unique<algorithm::BitParallelSimulator>(circuit, rows);
 #elif defined(BASELINE)
-        algorithm::BaselineSimulator simulator(circuit, rows);
+    return std::make_unique<algorithm::BaselineSimulator>(circuit, rows);
+#elif defined(HYBRIDMPI)
+    return std::make_unique<algorithm::HybridMpiFaultSimulator>(circuit, rows);
+#else
+    return std::make_unique<algorithm::BatchBaselineSimulator>(circuit, rows);
+#endif
+}
+
+struct Options {
+    std::string circuit_arg;
+    std::string output_path;
+    std::string append_from;
+    std::size_t append_count{0};
+    std::string checkpoint_path;
+    std::size_t checkpoint_chunk{1024};
+    bool resume{false};
+    std::string verify_sha;
+    bool transition{false};
+    std::size_t sample_faults{0};
+    std::uint64_t sample_seed{42};
+};
+
+bool parseArguments(int argc, char** argv, Options& options) {
+    if (argc < 3) {
+        return false;
+    }
+    options.circuit_arg = argv[1];
+    int i = 2;
+    if (std::string(argv[2]).rfind("--", 0) != 0) {
+        options.output_path = argv[i++];
+    }
+    for (; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--verify" && i + 1 < argc) {
+            options.verify_sha = argv[++i];
+        } else if (arg == "--append" && i + 2 < argc) {
+            options.append_from = argv[++i];
+            options.append_count = std::stoull(argv[++i]);
+        } else if (arg == "--checkpoint" && i + 1 < argc) {
+            options.checkpoint_path = argv[++i];
+        } else if (arg == "--checkpoint-chunk" && i + 1 < argc) {
+            options.checkpoint_chunk = std::stoull(argv[++i]);
+        } else if (arg == "--sample-faults" && i + 1 < argc) {
+            options.sample_faults = std::stoull(argv[++i]);
+        } else if (arg == "--seed" && i + 1 < argc) {
+            options.sample_seed = std::stoull(argv[++i]);
+        } else if (arg == "--transition") {
+            options.transition = true;
+        } else if (arg == "--resume") {
+            options.resume = true;
+        } else {
+            return false;
+        }
+    }
+    if (options.resume && options.checkpoint_path.empty()) {
+        return false;
+    }
+    if (options.sample_faults > 0) {
+        return options.output_path.empty() && options.verify_sha.empty() &&
+               options.append_from.empty() && options.checkpoint_path.empty() &&
+               !options.transition;
+    }
+    if (options.transition &&
+        (!options.append_from.empty() || !options.checkpoint_path.empty() ||
+         endsWith(options.output_path, ".ansb"))) {
+        return false;
+    }
+    if (!options.verify_sha.empty()) {
+        return options.output_path.empty() && options.append_from.empty();
+    }
+    if (!options.append_from.empty() && endsWith(options.output_path, ".ansb")) {
+        return false;
+    }
+    return !options.output_path.empty();
+}
+
+struct JobReport {
+    std::size_t pattern_count{0};
+    double compute_seconds{0.0};
+    double total_seconds{0.0};
+    bool ok{false};
+    std::string result;
+};
+
+// Runs one circuit end to end. Progress lines are only printed when `verbose`, so batch
+// jobs can share stderr; failures are reported by throwing.
+JobReport runJob(const Options& options, bool verbose) {
+    const std::string& circuit_arg = options.circuit_arg;
+    const std::string& output_path = options.output_path;
+    const bool append = !options.append_from.empty();
+    const bool verify = !options.verify_sha.empty();
+    const double job_start = getTimeStamp();
+    JobReport report;
+
+    const std::string expected_sha = verify ? expectedDigest(options.verify_sha) : "";
+    if (verbose) {
+        std::cerr << "Parsing circuit...\n";
+    }
+    const std::string circuit_file = circuitFileName(circuit_arg);
+    const std::string base_name = circuitBaseName(circuit_file);
+    const std::string circuit_path = "testcases/" + circuit_file;
+    const std::string pattern_path = "testcases/" + base_name + ".in";
+
+#ifdef LOCALITY_ORDER
+    auto circuit = io::parseCircuit(circuit_path, core::NetOrdering::Locality);
 #else
-        algorithm::BatchBaselineSimulator simulator(circuit, rows);
+    auto circuit = io::parseCircuit(circuit_path);
 #endif
+    // In append mode the rows already covered by the previous .ans are never parsed.
+    // Repeated input vectors are simulated once; the writer fans their answers back out.
+    // Transition grading reads consecutive rows as (launch, capture) pairs, kept in order.
+    io::DeduplicatedPatterns patterns;
+    if (options.transition) {
+        patterns.unique_rows = io::loadPatterns(circuit, pattern_path);
+    } else {
+        patterns = io::deduplicatePatterns(
+            circuit, io::loadPatterns(circuit, pattern_path, append ? options.append_count : 0));
+    }
+    const auto& rows = patterns.unique_rows;
+    report.pattern_count = patterns.source_row.empty() ? rows.size() : patterns.source_row.size();
+    std::vector<io::PatternRow> launch_rows;
+    std::vector<io::PatternRow> capture_rows;
+    if (options.transition) {
+        if (rows.size() % 2 != 0) {
+            throw std::runtime_error("Transition grading needs an even number of pattern rows");
+        }
+        for (std::size_t i = 0; i < rows.size(); ++i) {
+            (i % 2 == 0 ? launch_rows : capture_rows).push_back(rows[i]);
+        }
+        report.pattern_count = capture_rows.size();
+    }
+    if (verbose && !patterns.source_row.empty()) {
+        std::cerr << "Unique patterns: " << rows.size() << " of "
+                  << patterns.source_row.size() << '\n';
+    }
 
-        std::cout << simulator.describeIOShape() << '\n';
+    std::unique_ptr<algorithm::FaultSimulator> simulator;
+    if (io::hasUnknownValues(rows) && !options.checkpoint_path.empty()) {
+        throw std::runtime_error("Patterns with X values cannot be checkpointed");
+    }
+    if (options.transition) {
+        simulator = std::make_unique<algorithm::TransitionFaultSimulator>(circuit, launch_rows,
+                                                                          capture_rows);
+    } else if (!options.checkpoint_path.empty()) {
+        algorithm::CheckpointedSimulator::Options checkpoint;
+        checkpoint.path = options.checkpoint_path;
+        checkpoint.chunk_patterns = options.checkpoint_chunk;
+        checkpoint.resume = options.resume;
+        simulator = std::make_unique<algorithm::CheckpointedSimulator>(circuit, rows,
+                                                                        makeSimulator,
+                                                                        checkpoint);
+    } else {
+        simulator = makeSimulator(circuit, rows);
+    }
 
+    if (!simulator->supportsUnknownValues() && io::hasUnknownValues(rows)) {
+        throw std::runtime_error(
+            "Patterns contain X values; build with BITPARALLEL for 0/1/X simulation");
+    }
+
+    if (verbose) {
+        std::cout << simulator->describeIOShape() << '\n';
         std::cerr << "Precomputing answers...\n";
-        const double compute_start = getTimeStamp();
-        simulator.start();
-        const double compute_end = getTimeStamp();
-        const double compute_seconds = compute_end - compute_start;
-        std::cerr << "compute_time_s " << compute_seconds << '\n';
+    }
+    const double compute_start = getTimeStamp();
+    simulator->start();
+    const double compute_end = getTimeStamp();
+    report.compute_seconds = compute_end - compute_start;
+    if (verbose) {
+        std::cerr << "compute_time_s " << report.compute_seconds << '\n';
+    }
+#ifdef HYBRIDMPI
+    if (const auto* hybrid =
+            dynamic_cast<const algorithm::HybridMpiFaultSimulator*>(simulator.get())) {
+        if (hybrid->rank() != 0) {
+            report.ok = true;
+            report.result = "worker";
+            return report;
+        }
+        if (verbose) {
+            int thread_count = 1;
+#ifdef _OPENMP
+            thread_count = omp_get_max_threads();
+#endif
+            std::cerr << "mpi_ranks " << hybrid->size() << '\n';
+            std::cerr << "omp_threads " << thread_count << '\n';
+            std::cerr << "fault_compute_s " << hybrid->computeSeconds() << '\n';
+            std::cerr << "comm_wait_s " << hybrid->commWaitSeconds() << '\n';
+        }
+    }
+#endif
+
+    if (verify) {
+        if (verbose) {
+            std::cerr << "Hashing answers...\n";
+        }
+        const double verify_start = getTimeStamp();
+        const std::string digest = io::answerSha256(*simulator, patterns.source_row);
+        const double verify_seconds = getTimeStamp() - verify_start;
+        report.ok = digest == expected_sha;
+        report.result = report.ok ? "match" : "mismatch";
+        if (verbose) {
+            std::cerr << "verify_sha " << digest << '\n';
+            std::cerr << "verify_time_s " << verify_seconds << '\n';
+            std::cerr << "verify_result " << report.result << '\n';
+        }
+    } else {
+        if (verbose) {
+            std::cerr << "Writing output...\n";
+        }
+        if (append) {
+            io::appendAnswerFile(*simulator, options.append_from, options.append_count,
+                                 output_path, patterns.source_row);
+        } else if (endsWith(output_path, ".ansb")) {
+            io::writeBinaryAnswerFile(*simulator, output_path, patterns.source_row);
+        } else {
+            io::writeAnswerFile(*simulator, output_path, patterns.source_row);
+        }
+        report.ok = true;
+        report.result = "written";
+    }
+    report.total_seconds = getTimeStamp() - job_start;
+    return report;
+}
+
+struct BatchJob {
+    Options options;
+    std::uintmax_t cost{0};
+    JobReport report;
+};
+
+// Job lines use the config/pattern_targets.txt layout (`circuit [pattern_count [seed]]`);
+// only the circuit is used. Each job reads testcases/<ckt>.in and either writes
+// <output-dir>/<ckt>.ans or, when `verify`, checks testcases/<ckt>.ans.sha.
+std::vector<BatchJob> loadBatchJobs(const std::string& path, const std::string& output_dir,
+                                    bool verify) {
+    std::ifstream input(path);
+    if (!input) {
+        throw std::runtime_error("Unable to open batch file: " + path);
+    }
+    std::vector<BatchJob> jobs;
+    std::string line;
+    while (std::getline(input, line)) {
+        line = line.substr(0, line.find('#'));
+        std::istringstream fields(line);
+        std::string circuit_arg;
+        if (!(fields >> circuit_arg)) {
+            continue;
+        }
+        const std::string base_name = circuitBaseName(circuitFileName(circuit_arg));
+        BatchJob job;
+        job.options.circuit_arg = circuit_arg;
+        if (verify) {
+            job.options.verify_sha = "testcases/" + base_name + ".ans.sha";
+        } else {
+            job.options.output_path = output_dir + "/" + base_name + ".ans";
+        }
+        // Work grows with both the pattern count and the circuit size.
+        std::error_code ec;
+        const auto pattern_bytes = std::filesystem::file_size("testcases/" + base_name + ".in", ec);
+        const auto circuit_bytes =
+            std::filesystem::file_size("testcases/" + circuitFileName(circuit_arg), ec);
+        job.cost = ec ? 0 : pattern_bytes * circuit_bytes;
+        jobs.push_back(std::move(job));
+    }
+    if (jobs.empty()) {
+        throw std::runtime_error("Batch file lists no circuits: " + path);
+    }
+    return jobs;
+}
+
+void runBatchJob(BatchJob& job) {
+    try {
+        job.report = runJob(job.options, false);
+    } catch (const std::exception& ex) {
+        job.report.ok = false;
+        job.report.result = std::string("error: ") + ex.what();
+    }
+}
+
+void printCoverage(const char* label, std::size_t detected, std::size_t fault_count) {
+    const double percent =
+        fault_count == 0 ? 0.0 : 100.0 * static_cast<double>(detected) / fault_count;
+    std::cerr << label << ' ' << detected << '/' << fault_count << " (" << std::fixed
+              << std::setprecision(2) << percent << "%)\n"
+              << std::defaultfloat;
+}
+
+int runCompaction(const std::string& circuit_arg, const std::string& output_path) {
+    const std::string circuit_file = circuitFileName(circuit_arg);
+    const std::string base_name = circuitBaseName(circuit_file);
+    const std::string pattern_path = "testcases/" + base_name + ".in";
+    const auto circuit = io::parseCircuit("testcases/" + circuit_file);
+    const auto rows = io::loadPatterns(circuit, pattern_path);
+    if (io::hasUnknownValues(rows)) {
+        throw std::runtime_error("Patterns with X values cannot be compacted");
+    }
+
+    const double compact_start = getTimeStamp();
+    const auto result = algorithm::compactReverseOrder(circuit, rows);
+    std::cerr << "compact_time_s " << getTimeStamp() - compact_start << '\n';
+    io::writeSelectedPatterns(pattern_path, result.kept_rows, output_path);
+
+    std::cerr << "patterns_before " << rows.size() << '\n';
+    std::cerr << "patterns_after " << result.kept_rows.size() << '\n';
+    printCoverage("coverage_before", result.detected_before, result.fault_count);
+    printCoverage("coverage_after", result.detected_after, result.fault_count);
+    return result.detected_after == result.detected_before ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+int runDictionary(const std::string& circuit_arg, const std::string& output_path) {
+    const std::string circuit_file = circuitFileName(circuit_arg);
+    const std::string base_name = circuitBaseName(circuit_file);
+    const auto circuit = io::parseCircuit("testcases/" + circuit_file);
+    const auto rows = io::loadPatterns(circuit, "testcases/" + base_name + ".in");
+    if (io::hasUnknownValues(rows)) {
+        throw std::runtime_error("Patterns with X values cannot be put in a fault dictionary");
+    }
+    std::vector<core::Pattern> patterns;
+    patterns.reserve(rows.size());
+    for (const auto& row : rows) {
+        patterns.push_back(row.pattern);
+    }
+
+    const double dictionary_start = getTimeStamp();
+    const auto dictionary = algorithm::buildFaultDictionary(circuit, patterns);
+    std::cerr << "dictionary_time_s " << getTimeStamp() - dictionary_start << '\n';
+    const double write_start = getTimeStamp();
+    io::writeFaultDictionaryFile(circuit, dictionary, output_path);
+    std::cerr << "write_time_s " << getTimeStamp() - write_start << '\n';
+    std::cerr << "dictionary_bytes " << std::filesystem::file_size(output_path) << '\n';
+    printCoverage("coverage", dictionary.detectedFaults(), dictionary.fault_count);
+    return EXIT_SUCCESS;
+}
+
+int runSampling(const Options& options) {
+    const std::string circuit_file = circuitFileName(options.circuit_arg);
+    const std::string base_name = circuitBaseName(circuit_file);
+    const auto circuit = io::parseCircuit("testcases/" + circuit_file);
+    const auto rows = io::loadPatterns(circuit, "testcases/" + base_name + ".in");
+    if (io::hasUnknownValues(rows)) {
+        throw std::runtime_error("Patterns with X values cannot be fault sampled");
+    }
+
+    const double sample_start = getTimeStamp();
+    const auto estimate =
+        algorithm::estimateCoverage(circuit, rows, options.sample_faults, options.sample_seed);
+    std::cerr << "sample_time_s " << getTimeStamp() - sample_start << '\n';
+    std::cerr << "sampled_faults " << estimate.sample_size << '/' << estimate.population
+              << " in " << estimate.strata << " strata\n";
+    std::cerr << "sample_detected " << estimate.detected_in_sample << '\n';
+    std::cerr << std::fixed << std::setprecision(2);
+    std::cerr << "coverage_estimate " << 100.0 * estimate.coverage << "%\n";
+    std::cerr << "coverage_ci95 " << 100.0 * estimate.lower << "% " << 100.0 * estimate.upper
+              << "%\n";
+    std::cerr << std::defaultfloat;
+    return EXIT_SUCCESS;
+}
+
+int runClient(const std::string& socket_path, const std::string& circuit_arg,
+              const std::string& output_path, const std::string& mode_name) {
+    io::SimulationClient client(socket_path);
+    if (mode_name == "shutdown") {
+        client.shutdown();
+        return EXIT_SUCCESS;
+    }
+    io::ServerMode mode = io::ServerMode::Full;
+    if (mode_name == "coverage") {
+        mode = io::ServerMode::Coverage;
+    } else if (mode_name == "detect") {
+        mode = io::ServerMode::DetectOnly;
+    } else if (mode_name != "full") {
+        throw std::runtime_error("Unknown server mode: " + mode_name);
+    }
+
+    const std::string circuit_file = circuitFileName(circuit_arg);
+    const std::string base_name = circuitBaseName(circuit_file);
+    const auto circuit = io::parseCircuit("testcases/" + circuit_file);
+    const auto rows = io::loadPatterns(circuit, "testcases/" + base_name + ".in");
+    std::vector<core::Pattern> patterns;
+    patterns.reserve(rows.size());
+    for (const auto& row : rows) {
+        patterns.push_back(row.pattern);
+    }
+    const auto packed = core::PackedPatterns::pack(circuit, patterns, 0, patterns.size());
+
+    const double request_start = getTimeStamp();
+    const std::vector<char> payload = client.request(base_name, mode, packed);
+    std::cerr << "request_time_s " << getTimeStamp() - request_start << '\n';
+    std::ofstream output(output_path, std::ios::binary);
+    if (!output.write(payload.data(), static_cast<std::streamsize>(payload.size()))) {
+        throw std::runtime_error("Unable to write output file: " + output_path);
+    }
+    return EXIT_SUCCESS;
+}
+
+// Largest jobs first. A job bigger than its fair share of the remaining work gets every
+// thread to itself; the rest run concurrently, one job per thread, from one OpenMP team.
+int runBatch(const std::string& path, const std::string& output_dir, bool verify) {
+    const double batch_start = getTimeStamp();
+    std::vector<BatchJob> jobs = loadBatchJobs(path, output_dir, verify);
+    std::vector<std::size_t> order(jobs.size());
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+        return jobs[a].cost > jobs[b].cost;
+    });
+
+    std::uintmax_t remaining = 0;
+    for (const auto& job : jobs) {
+        remaining += job.cost;
+    }
+    int thread_count = 1;
+#ifdef _OPENMP
+    thread_count = std::max(1, omp_get_max_threads());
+#endif
+    std::size_t next = 0;
+    while (next < order.size() &&
+           (thread_count == 1 || jobs[order[next]].cost * thread_count > remaining)) {
+        remaining -= jobs[order[next]].cost;
+        runBatchJob(jobs[order[next]]);
+        ++next;
+    }
+
+#ifdef _OPENMP
+    omp_set_max_active_levels(1);
+#endif
+#pragma omp parallel for schedule(dynamic, 1)
+    for (long long i = static_cast<long long>(next); i < static_cast<long long>(order.size());
+         ++i) {
+        runBatchJob(jobs[order[static_cast<std::size_t>(i)]]);
+    }
+
+    bool all_ok = true;
+    std::cerr << std::left << std::setw(12) << "circuit" << std::right << std::setw(10)
+              << "patterns" << std::setw(12) << "compute_s" << std::setw(12) << "total_s"
+              << "  result\n";
+    for (const auto& job : jobs) {
+        all_ok = all_ok && job.report.ok;
+        std::cerr << std::left << std::setw(12) << job.options.circuit_arg << std::right
+                  << std::setw(10) << job.report.pattern_count << std::setw(12)
+                  << job.report.compute_seconds << std::setw(12) << job.report.total_seconds
+                  << "  " << job.report.result << '\n';
+    }
+    std::cerr << "batch_time_s " << getTimeStamp() - batch_start << '\n';
+    return all_ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+// Writes one CSV row per (circuit, engine, thread count). Answers are checked against
+// testcases/<ckt>.ans.sha when it exists.
+int runScaling(int argc, char** argv) {
+    const std::string output_path = argv[2];
+    std::vector<std::string> circuits;
+    algorithm::ScalingOptions options;
+    for (int i = 3; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--threads" && i + 1 < argc) {
+            options.max_threads = std::stoi(argv[++i]);
+        } else if (arg == "--repeat" && i + 1 < argc) {
+            options.repeats = std::stoi(argv[++i]);
+        } else if (arg == "--engines" && i + 1 < argc) {
+            std::istringstream list(argv[++i]);
+            std::string name;
+            while (std::getline(list, name, ',')) {
+                const auto& known = algorithm::scalableEngineNames();
+                if (std::find(known.begin(), known.end(), name) == known.end()) {
+                    throw std::runtime_error("Unknown scalable engine: " + name);
+                }
+                options.engines.push_back(name);
+            }
+        } else if (arg.rfind("--", 0) == 0) {
+            throw std::runtime_error("Unknown --scaling option: " + arg);
+        } else {
+            circuits.push_back(arg);
+        }
+    }
+    if (circuits.empty()) {
+        throw std::runtime_error("--scaling needs at least one circuit");
+    }
+    const char* wait_policy = std::getenv("OMP_WAIT_POLICY");
+    if (!wait_policy || std::string(wait_policy) != "passive") {
+        std::cerr << "note: threads spinning at barriers count as busy; set "
+                     "OMP_WAIT_POLICY=passive for load_imbalance\n";
+    }
+
+    std::ofstream csv(output_path);
+    if (!csv) {
+        throw std::runtime_error("Unable to write output file: " + output_path);
+    }
+    csv << "circuit,nets,patterns,engine,threads,seconds,speedup,efficiency,cpu_seconds,"
+           "load_imbalance,llc_miss_bytes,memory_gbps,stream_gbps,answers\n";
+    bool all_ok = true;
+    for (const auto& circuit_arg : circuits) {
+        const std::string circuit_file = circuitFileName(circuit_arg);
+        const std::string base_name = circuitBaseName(circuit_file);
+        const auto circuit = io::parseCircuit("testcases/" + circuit_file);
+        const auto patterns = io::deduplicatePatterns(
+            circuit, io::loadPatterns(circuit, "testcases/" + base_name + ".in"));
+        const std::string sha_path = "testcases/" + base_name + ".ans.sha";
+        const bool checked = std::filesystem::exists(sha_path);
+        options.check = nullptr;
+        if (checked) {
+            const std::string expected = expectedDigest(sha_path);
+            options.check = [&patterns, expected](const algorithm::FaultSimulator& simulator) {
+                return io::answerSha256(simulator, patterns.source_row) == expected;
+            };
+        }
+        const std::size_t pattern_count = patterns.source_row.empty()
+                                              ? patterns.unique_rows.size()
+                                              : patterns.source_row.size();
+        std::cerr << "scaling " << base_name << " (" << circuit.netCount() << " nets, "
+                  << pattern_count << " patterns)\n";
+
+        const auto samples =
+            algorithm::measureThreadScaling(circuit, patterns.unique_rows, options);
+        for (const auto& sample : samples) {
+            all_ok = all_ok && sample.answers_ok;
+            csv << base_name << ',' << circuit.netCount() << ',' << pattern_count << ','
+                << sample.engine << ',' << sample.threads << ',' << sample.seconds << ','
+                << sample.speedup << ',' << sample.efficiency << ',' << sample.cpu_seconds
+                << ',' << sample.load_imbalance << ',';
+            if (sample.miss_bytes >= 0.0) {
+                csv << sample.miss_bytes << ',' << sample.memory_gbps;
+            } else {
+                csv << ',';
+            }
+            csv << ',' << sample.stream_gbps << ','
+                << (!checked ? "unchecked" : sample.answers_ok ? "match" : "mismatch") << '\n';
+            std::cerr << "  " << std::left << std::setw(28) << sample.engine << std::right
+                      << std::setw(4) << sample.threads << std::setw(12) << sample.seconds
+                      << "s  x" << sample.speedup << '\n';
+        }
+    }
+    if (!csv) {
+        throw std::runtime_error("Failed to write scaling results: " + output_path);
+    }
+    return all_ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
 
-        std::cerr << "Writing output...\n";
-        io::writeAnswerFile(simulator, output_path);
+// Good-machine micro-benchmark: Simulator::simulateWords (switch on GateType per gate) against
+// TruthTableSimulator on the same random words. Reports the best of `repeat` passes.
+int runEvalBenchmark(int argc, char** argv) {
+    std::size_t words = 16;
+    int repeat = 20;
+    for (int i = 3; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--words" && i + 1 < argc) {
+            words = static_cast<std::size_t>(std::stoul(argv[++i]));
+        } else if (arg == "--repeat" && i + 1 < argc) {
+            repeat = std::stoi(argv[++i]);
+        } else {
+            throw std::runtime_error("Unknown --bench-eval option: " + arg);
+        }
+    }
+    if (words == 0 || repeat <= 0) {
+        throw std::runtime_error("--bench-eval needs positive --words and --repeat");
+    }
+    const auto circuit = io::parseCircuit("testcases/" + circuitFileName(argv[2]));
+
+    core::PackedPatterns patterns;
+    patterns.pattern_count = words * 64;
+    patterns.word_count = words;
+    patterns.inputs.resize(circuit.primaryInputs().size() * words);
+    std::mt19937_64 rng(1);
+    for (auto& word : patterns.inputs) {
+        word = rng();
+    }
+
+    const core::Simulator switch_sim(circuit);
+    const core::TruthTableSimulator table_sim(circuit);
+    std::vector<std::uint64_t> switch_words;
+    std::vector<std::uint64_t> table_words;
+    auto best = [repeat](auto&& pass) {
+        double seconds = 0.0;
+        for (int r = 0; r < repeat; ++r) {
+            const auto begin = std::chrono::steady_clock::now();
+            pass();
+            const double elapsed =
+                std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+            seconds = r == 0 ? elapsed : std::min(seconds, elapsed);
+        }
+        return seconds;
+    };
+    const double switch_s = best([&] { switch_sim.simulateWords(patterns, switch_words); });
+    const double table_s = best([&] { table_sim.simulateWords(patterns, table_words); });
+
+    const double gate_words = static_cast<double>(circuit.gates().size() * words);
+    const bool match = switch_words == table_words;
+    std::cout << std::left << std::setw(14) << "evaluator" << std::right << std::setw(8) << "ops"
+              << std::setw(14) << "seconds" << std::setw(16) << "ns/gate-word\n";
+    std::cout << std::left << std::setw(14) << "switch" << std::right << std::setw(8)
+              << circuit.gates().size() << std::setw(14) << switch_s << std::setw(15)
+              << switch_s * 1e9 / gate_words << '\n';
+    std::cout << std::left << std::setw(14) << "truth-table" << std::right << std::setw(8)
+              << table_sim.opCount() << std::setw(14) << table_s << std::setw(15)
+              << table_s * 1e9 / gate_words << '\n';
+    std::cout << "speedup " << (table_s > 0.0 ? switch_s / table_s : 0.0) << "  outputs "
+              << (match ? "match" : "MISMATCH") << '\n';
+    return match ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+#ifdef HYBRIDMPI
+// Every rank runs the same job; rank 0 alone reports and writes or verifies the answers.
+int runHybrid(int argc, char** argv) {
+    int rank = 0;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    Options options;
+    bool parsed = false;
+    try {
+        parsed = std::string(argv[1 < argc ? 1 : 0]).rfind("--", 0) != 0 &&
+                 parseArguments(argc, argv, options);
+    } catch (const std::exception&) {
+        parsed = false;
+    }
+    if (!parsed || options.sample_faults > 0 || options.transition ||
+        !options.checkpoint_path.empty()) {
+        if (rank == 0) {
+            printUsage(argv[0]);
+            std::cerr << "  HYBRIDMPI builds only run plain <output-path> and --verify jobs\n";
+        }
+        return EXIT_FAILURE;
+    }
+    try {
+        return runJob(options, rank == 0).ok ? EXIT_SUCCESS : EXIT_FAILURE;
+    } catch (const std::exception& ex) {
+        std::cerr << "Error: " << ex.what() << '\n';
+        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+    }
+    return EXIT_FAILURE;
+}
+#endif
+
+}  // namespace
 
+int main(int argc, char** argv) {
+#ifdef HYBRIDMPI
+    int provided = 0;
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &provided);
+    const int status = runHybrid(argc, argv);
+    MPI_Finalize();
+    return status;
+#endif
+    if (argc == 4 && std::string(argv[1]) == "--ansb-to-text") {
+        try {
+            const double convert_start = getTimeStamp();
+            io::convertBinaryAnswersToText(argv[2], argv[3]);
+            std::cerr << "convert_time_s " << getTimeStamp() - convert_start << '\n';
+        } catch (const std::exception& ex) {
+            std::cerr << "Error: " << ex.what() << '\n';
+            return EXIT_FAILURE;
+        }
+        return EXIT_SUCCESS;
+    }
+    if (argc == 4 && std::string(argv[1]) == "--compact") {
+        try {
+            return runCompaction(argv[2], argv[3]);
+        } catch (const std::exception& ex) {
+            std::cerr << "Error: " << ex.what() << '\n';
+            return EXIT_FAILURE;
+        }
+    }
+    if (argc == 4 && std::string(argv[1]) == "--dictionary") {
+        try {
+            return runDictionary(argv[2], argv[3]);
+        } catch (const std::exception& ex) {
+            std::cerr << "Error: " << ex.what() << '\n';
+            return EXIT_FAILURE;
+        }
+    }
+    if (argc == 4 && std::string(argv[1]) == "--batch") {
+        const bool verify = std::string(argv[3]) == "--verify";
+        try {
+            return runBatch(argv[2], verify ? "" : argv[3], verify);
+        } catch (const std::exception& ex) {
+            std::cerr << "Error: " << ex.what() << '\n';
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (argc >= 4 && std::string(argv[1]) == "--scaling") {
+        try {
+            return runScaling(argc, argv);
+        } catch (const std::exception& ex) {
+            std::cerr << "Error: " << ex.what() << '\n';
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (argc >= 3 && std::string(argv[1]) == "--bench-eval") {
+        try {
+            return runEvalBenchmark(argc, argv);
+        } catch (const std::exception& ex) {
+            std::cerr << "Error: " << ex.what() << '\n';
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (argc == 3 && std::string(argv[1]) == "--serve") {
+        try {
+            io::runSimulationServer(argv[2], makeSimulator);
+        } catch (const std::exception& ex) {
+            std::cerr << "Error: " << ex.what() << '\n';
+            return EXIT_FAILURE;
+        }
+        return EXIT_SUCCESS;
+    }
+    if ((argc == 5 || argc == 6) && std::string(argv[1]) == "--client") {
+        try {
+            return runClient(argv[2], argv[3], argv[4], argc == 6 ? argv[5] : "full");
+        } catch (const std::exception& ex) {
+            std::cerr << "Error: " << ex.what() << '\n';
+            return EXIT_FAILURE;
+        }
+    }
+
+    Options options;
+    try {
+        if (!parseArguments(argc, argv, options)) {
+            printUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    } catch (const std::exception&) {
+        printUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    try {
+        if (options.sample_faults > 0) {
+            return runSampling(options);
+        }
+        if (!runJob(options, true).ok) {
+            return EXIT_FAILURE;
+        }
     } catch (const std::exception& ex) {
         std::cerr << "Error: " << ex.what() << '\n';
         return EXIT_FAILURE;